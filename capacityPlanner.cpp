@@ -0,0 +1,185 @@
+// 容量规划工具: 读一遍访问轨迹, 输出各策略在不同容量下的命中率
+// 轨迹每行一个请求: "get <key>" 或 "put <key>"(也接受 g/r/read 与 p/w/set/write), 只有 key 的行视为读.
+// 非数字的 key 取字符串哈希.
+// LRU 用 SHARDS 抽样 + 栈距离一次得到整条曲线; LFU / ARC / LRU-K 以及作为对照的 LRU 对每个容量
+// 跑一个缩小的模拟缓存(容量 * 抽样率, 值只占一个字节), 只喂给哈希落在抽样范围内的键.
+// 抽样率取值 (0, 1]; 容量 * 抽样率很小时 LRU(MRC) 列只是粗略估计, 输出中标 '~'.
+//
+// 用法: CapacityPlanner [轨迹文件|-] [--rate 0.01] [--capacities 100,1000,10000]
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "caChePolicy.h"
+#include "ArcCache.h"
+#include "CacheLocking.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "LruKCache.h"
+#include "StackDistance.h"
+
+namespace {
+
+// 一个容量点上某个策略的缩小模拟
+struct MiniSimulation {
+    std::unique_ptr<caChepolicy<uint64_t, char>> cache;
+    double rate;
+    uint64_t reads = 0;
+    uint64_t hits = 0;
+
+    void access(uint64_t key, bool isRead) {
+        if (!StackDistanceProfiler::sampled(key, rate)) return;
+        if (isRead) {
+            char value;
+            ++reads;
+            if (cache->get(key, value)) ++hits;
+        } else {
+            cache->put(key, 0);
+        }
+    }
+    double hitRate() const {return reads ? static_cast<double>(hits) / reads : 0;}
+};
+
+const char* kPolicyNames[] = {"LRU", "LFU", "ARC", "LRU-K"};
+constexpr int kPolicyCount = 4;
+
+std::unique_ptr<caChepolicy<uint64_t, char>> makeSimulation(int policy, int capacity) {
+    switch (policy) {
+        case 1: return std::make_unique<LfuCache<uint64_t, char, NullMutex>>(capacity);
+        case 2: return std::make_unique<ArcCahce<uint64_t, char, NullMutex>>(capacity, 2);
+        case 3: return std::make_unique<LruKCache<uint64_t, char>>(capacity, capacity, 2);
+        default: return std::make_unique<LruCache<uint64_t, char, NullMutex>>(capacity);
+    }
+}
+
+bool parseLine(const std::string& line, uint64_t& key, bool& isRead) {
+    std::istringstream in(line);
+    std::string first, second;
+    if (!(in >> first)) return false;
+    std::string keyText = first;
+    isRead = true;
+    if (in >> second) {
+        keyText = second;
+        isRead = !(first == "put" || first == "p" || first == "w" || first == "set" || first == "write");
+    }
+    char* end = nullptr;
+    key = std::strtoull(keyText.c_str(), &end, 10);
+    if (end == keyText.c_str() || *end != '\0') key = std::hash<std::string>{}(keyText);
+    return true;
+}
+
+// 逗号分隔的正整数(不超过 INT_MAX, 模拟缓存的容量为 int); 任何一项不合法时返回 false
+bool parseCapacities(const std::string& text, std::vector<size_t>& capacities) {
+    capacities.clear();
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (item.empty()) continue;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long capacity = std::strtoull(item.c_str(), &end, 10);
+        if (item[0] == '-' || *end != '\0' || errno == ERANGE || capacity == 0
+            || capacity > static_cast<unsigned long long>(INT_MAX)) return false;
+        capacities.push_back(static_cast<size_t>(capacity));
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [轨迹文件|-] [--rate 0.01] [--capacities 100,1000,10000]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = "-";
+    double rate = 0.01;
+    std::vector<size_t> capacities;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) {
+            char* end = nullptr;
+            rate = std::strtod(argv[++i], &end);
+            if (*end != '\0') rate = 0; // 不是完整的数字, 下面按非法抽样率报错
+        }
+        else if (arg == "--capacities" && i + 1 < argc) {
+            if (!parseCapacities(argv[++i], capacities)) {
+                std::cerr << "容量必须是逗号分隔的正整数: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else path = arg;
+    }
+    if (!(rate > 0 && rate <= 1)) {
+        std::cerr << "抽样率必须在 (0, 1] 之内" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (capacities.empty()) {
+        for (size_t capacity = 16; capacity <= 65536; capacity *= 2) capacities.push_back(capacity);
+    }
+
+    // 小容量按全局抽样率缩小后条目太少, 误差很大; 每个容量点至少保留约 128 个条目
+    std::vector<std::vector<MiniSimulation>> simulations(capacities.size());
+    for (size_t c = 0; c < capacities.size(); ++c) {
+        double pointRate = std::min(1.0, std::max(rate, 128.0 / capacities[c]));
+        int scaled = std::max(1, static_cast<int>(capacities[c] * pointRate + 0.5));
+        for (int policy = 0; policy < kPolicyCount; ++policy)
+            simulations[c].push_back(MiniSimulation{makeSimulation(policy, scaled), pointRate});
+    }
+    StackDistanceProfiler profiler(rate);
+
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            std::cerr << "无法打开轨迹文件: " << path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = path == "-" ? std::cin : file;
+
+    uint64_t requests = 0;
+    std::string line;
+    uint64_t key;
+    bool isRead;
+    while (std::getline(in, line)) {
+        if (!parseLine(line, key, isRead)) continue;
+        ++requests;
+        profiler.access(key, isRead);
+        for (auto& point : simulations)
+            for (auto& simulation : point) simulation.access(key, isRead);
+    }
+
+    std::cout << "请求数: " << requests << " 抽样率: " << rate
+              << " 抽样读请求: " << profiler.sampledReads()
+              << " 抽样键: " << profiler.sampledKeys() << std::endl;
+    std::cout << std::setw(10) << "capacity" << std::setw(14) << "LRU(MRC)";
+    for (const char* name : kPolicyNames) std::cout << std::setw(10) << name;
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t c = 0; c < capacities.size(); ++c) {
+        // 抽样后格数太少的 LRU(MRC) 值标 '~', 以同一行按容量单独抽样的 LRU 模拟为准
+        std::cout << std::setw(10) << capacities[c] << std::setw(12) << 100 * profiler.hitRate(capacities[c]) << "%"
+                  << (profiler.reliable(capacities[c]) ? ' ' : '~');
+        for (const auto& simulation : simulations[c]) std::cout << std::setw(9) << 100 * simulation.hitRate() << "%";
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "caChePolicy.h"
+#include "ArcCache.h"
+#include "CacheLocking.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "TinyLfuCache.h"
+
+enum class CachePolicy{
+    Lru,
+    Lfu,
+    Arc,
+    TinyLfu,
+};
+
+inline const char* policyName(CachePolicy policy){
+    switch (policy){
+        case CachePolicy::Lru: return "LRU";
+        case CachePolicy::Lfu: return "LFU";
+        case CachePolicy::Arc: return "ARC";
+        case CachePolicy::TinyLfu: return "TinyLFU";
+    }
+    return "?";
+}
+
+// 自适应策略缓存
+// 按键哈希抽样(SHARDS 的空间抽样)一部分请求, 喂给每种策略的缩小版影子缓存(容量 = 容量 * 抽样率,
+// 值只占一个字节), 比较各影子的命中数. 每 period 次抽样读请求评估一次, 领先者超过当前策略一定幅度
+// 才切换, 避免来回抖动.
+// 切换时新建目标策略的缓存, 旧缓存保留为只读后备: 新缓存未命中时从旧缓存取值并迁入, 新缓存写入的
+// 不同键数量达到容量后丢弃旧缓存.
+// 开销: 被抽样的操作额外访问 kPolicies 个影子缓存, 抽样率不超过 kMaxSampleRate.
+// 场景 12 的访问序列(容量 500, 30 万次操作, 5 次取最快): 总计 62ms, 其中四个影子合计 12ms(抽样率不设
+// 上限为 0.51 时 51ms), 活动缓存 55ms(大部分时间运行 ARC, 只用 ARC 为 57ms, 只用 LRU 为 17ms);
+// 迁移期间(约 8900 次操作)查找与插入 _fresh 的开销在计时误差之内.
+// 内存: 活动缓存 + 四个影子(各 容量 * 抽样率 个条目) + 迁移期间的旧缓存(最多一个完整容量)
+// + _fresh(最多 容量 个键), 即切换后的一段时间内最多约为单个缓存的两倍多.
+template<typename Key, typename Value, typename Mutex = std::mutex>
+class AdaptiveCache : public caChepolicy<Key, Value>{
+public:
+    static constexpr int kPolicies = 4;
+
+    // sampleRate <= 0 时按容量自动选择, 使影子缓存约有 256 个条目, 但抽样率不超过 kMaxSampleRate
+    explicit AdaptiveCache(int capacity, CachePolicy initial = CachePolicy::Lru, double sampleRate = 0)
+        : _capacity(capacity > 0 ? capacity : 0)
+        , _policy(initial)
+    {
+        if (sampleRate <= 0) sampleRate = _capacity > 256 ? std::min(256.0 / _capacity, kMaxSampleRate) : kMaxSampleRate;
+        if (sampleRate > 1) sampleRate = 1;
+        _sampleThreshold = static_cast<uint32_t>(sampleRate * kSampleSpace);
+        int shadowCapacity = static_cast<int>(_capacity * sampleRate + 0.5);
+        if (shadowCapacity < 1) shadowCapacity = 1;
+        for (int i = 0; i < kPolicies; ++i)
+            _shadows[i] = makePolicy<char>(static_cast<CachePolicy>(i), shadowCapacity);
+        _period = shadowCapacity * 4 > 512 ? shadowCapacity * 4 : 512;
+        _live = makePolicy<Value>(_policy, _capacity);
+    }
+    ~AdaptiveCache() override = default;
+
+    void put(Key key, const Value& value) override{
+        std::lock_guard<Mutex> lock(_mutex);
+        if (sampled(key)){
+            for (auto& shadow : _shadows) shadow->put(key, 0);
+        }
+        _live->put(key, value);
+        if (_previous) markFresh(key);
+    }
+
+    bool get(Key key, Value& value) override{
+        std::lock_guard<Mutex> lock(_mutex);
+        if (sampled(key)) simulateGet(key);
+        if (_live->get(key, value)) return true;
+        if (_previous && _fresh.find(key) == _fresh.end() && _previous->get(key, value)){
+            _live->put(key, value);
+            markFresh(key);
+            return true;
+        }
+        return false;
+    }
+
+    Value get(Key key) override{
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    CachePolicy policy() {
+        std::lock_guard<Mutex> lock(_mutex);
+        return _policy;
+    }
+    size_t switches() {
+        std::lock_guard<Mutex> lock(_mutex);
+        return _switches;
+    }
+
+private:
+    static constexpr uint32_t kSampleSpace = 1u << 16;
+    static constexpr double kMaxSampleRate = 0.125; // 容量很小时抽样率接近 1, 影子的开销会超过活动缓存本身
+
+    template<typename V>
+    static std::unique_ptr<caChepolicy<Key, V>> makePolicy(CachePolicy policy, int capacity){
+        switch (policy){
+            case CachePolicy::Lfu: return std::make_unique<LfuCache<Key, V, NullMutex>>(capacity);
+            case CachePolicy::Arc: return std::make_unique<ArcCahce<Key, V, NullMutex>>(capacity, 2);
+            case CachePolicy::TinyLfu: return std::make_unique<TinyLfuCache<Key, V, NullMutex>>(capacity);
+            case CachePolicy::Lru: break;
+        }
+        return std::make_unique<LruCache<Key, V, NullMutex>>(capacity);
+    }
+
+    bool sampled(const Key& key) const {
+        uint64_t h = std::hash<Key>{}(key) * 0x9e3779b97f4a7c15ULL;
+        return static_cast<uint32_t>(h >> 48) < _sampleThreshold;
+    }
+
+    void simulateGet(const Key& key){
+        char dummy;
+        for (int i = 0; i < kPolicies; ++i){
+            if (_shadows[i]->get(key, dummy)) ++_hits[i];
+        }
+        if (++_sampledGets >= _period) evaluate();
+    }
+
+    void evaluate(){
+        int best = static_cast<int>(_policy);
+        for (int i = 0; i < kPolicies; ++i){
+            if (_hits[i] > _hits[best]) best = i;
+        }
+        // 领先当前策略超过本周期抽样读请求的 2% 才切换
+        if (best != static_cast<int>(_policy) && _hits[best] - _hits[static_cast<int>(_policy)] > _period / 50)
+            switchTo(static_cast<CachePolicy>(best));
+        // 命中数指数衰减, 保留一半历史
+        for (auto& hits : _hits) hits /= 2;
+        _sampledGets = 0;
+    }
+
+    void switchTo(CachePolicy policy){
+        _previous = std::move(_live);
+        _fresh.clear();
+        _fresh.reserve(static_cast<size_t>(_capacity));
+        _live = makePolicy<Value>(policy, _capacity);
+        _policy = policy;
+        ++_switches;
+    }
+
+    // 新缓存写过的键不能再从旧缓存读取, 否则会读到旧值
+    void markFresh(const Key& key){
+        _fresh.insert(key);
+        if (_fresh.size() >= static_cast<size_t>(_capacity)){
+            _previous.reset();
+            _fresh.clear();
+        }
+    }
+
+private:
+    int _capacity;
+    CachePolicy _policy;
+    uint32_t _sampleThreshold;
+    size_t _period;
+    size_t _sampledGets = 0;
+    size_t _switches = 0;
+    std::array<std::unique_ptr<caChepolicy<Key, char>>, kPolicies> _shadows;
+    std::array<size_t, kPolicies> _hits{};
+    std::unique_ptr<caChepolicy<Key, Value>> _live;
+    std::unique_ptr<caChepolicy<Key, Value>> _previous; // 切换前的缓存, 迁移完成前只读
+    std::unordered_set<Key> _fresh;
+    Mutex _mutex;
+};
@@ -3,20 +3,29 @@
 #include "caChePolicy.h"
 #include "ArcLfuPart.h"
 #include "ArcLruPart.h"
+#include "RemovalListener.h"
+#include <atomic>
 #include <memory>
 
-template<typename Key, typename Value>
+// Mutex 与 Alloc 传给 LRU / LFU 两部分, NullMutex 即为不加锁版本
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>>
 class ArcCahce : public caChepolicy<Key, Value>{
 public:
-    explicit ArcCahce(size_t capacity, size_t transformThreshold)
+    explicit ArcCahce(size_t capacity, size_t transformThreshold, const Alloc& alloc = Alloc())
         : _capacity(capacity)
         , _transformThreshold(transformThreshold)
-        , _lruPart(std::make_unique<ArcLruPart<Key, Value>>(_capacity, _transformThreshold))
-        , _lfuPart(std::make_unique<ArcLfuPart<Key, Value>>(_capacity, _transformThreshold))
+        , _lruPart(std::make_unique<ArcLruPart<Key, Value, Mutex, Alloc>>(_capacity, _transformThreshold, alloc))
+        , _lfuPart(std::make_unique<ArcLfuPart<Key, Value, Mutex, Alloc>>(_capacity, _transformThreshold, alloc))
     {}
     ~ArcCahce() override = default;
 
     void put(Key key, const Value& value) override{
+        if (_notifier.enabled())
+        {
+            Value oldValue{};
+            if (_lruPart->peek(key, oldValue) || _lfuPart->peek(key, oldValue))
+                _notifier.record(key, oldValue, RemovalCause::Replaced);
+        }
         checkGhostCaches(key);
         // 检查 LFU 部分是否存在该键
         bool inLfu = _lfuPart->contain(key);
@@ -27,6 +36,7 @@ public:
         {
             _lfuPart->put(key, value);
         }       
+        _notifier.dispatch();
     }
 
     bool get(Key key, Value& value) override 
@@ -50,7 +60,45 @@ public:
         return value;
     }
 
+    // 后台维护: 两部分各自淘汰到低水位并裁剪幽灵链表, 返回完成的工作量
+    size_t maintain(size_t budget) {
+        double lowWatermark = _lowWatermark.load(std::memory_order_relaxed);
+        size_t done = _lruPart->maintain(budget, lowWatermark);
+        if (done < budget) done += _lfuPart->maintain(budget - done, lowWatermark);
+        return done;
+    }
+    // 低水位(容量的比例), 默认 1.0 即不主动淘汰
+    void setLowWatermark(double ratio) {_lowWatermark.store(ratio, std::memory_order_relaxed);}
+
+    // 移除监听器: 键只有在 LRU、LFU 两部分都不存在时才算被淘汰
+    void setRemovalListener(typename RemovalNotifier<Key, Value>::Listener listener, size_t batchSize = 64) {
+        _notifier.setListener(std::move(listener), batchSize);
+        _lruPart->setRemovalListener([this](const std::vector<RemovalNotification<Key, Value>>& batch) {
+            forwardRemovals(batch, *_lfuPart);
+        }, 1);
+        _lfuPart->setRemovalListener([this](const std::vector<RemovalNotification<Key, Value>>& batch) {
+            forwardRemovals(batch, *_lruPart);
+        }, 1);
+    }
+    void flushRemovals() {
+        _lruPart->flushRemovals();
+        _lfuPart->flushRemovals();
+        _notifier.flush();
+    }
+
 private:
+    // 部分淘汰的通知在其锁外投递, 这里再查询另一部分, 过滤掉仍然被缓存的键
+    template<typename OtherPart>
+    void forwardRemovals(const std::vector<RemovalNotification<Key, Value>>& batch, OtherPart& other)
+    {
+        for (const auto& notification : batch)
+        {
+            if (!other.contain(notification.key))
+                _notifier.record(notification.key, notification.value, notification.cause);
+        }
+        _notifier.dispatch();
+    }
+
     bool checkGhostCaches(Key key) 
     {
         bool inGhost = false;
@@ -76,6 +124,8 @@ private:
 private:
     size_t _capacity;
     size_t _transformThreshold;
-    std::unique_ptr<ArcLruPart<Key, Value>> _lruPart;
-    std::unique_ptr<ArcLfuPart<Key, Value>> _lfuPart;
+    std::atomic<double> _lowWatermark{1.0};
+    std::unique_ptr<ArcLruPart<Key, Value, Mutex, Alloc>> _lruPart;
+    std::unique_ptr<ArcLfuPart<Key, Value, Mutex, Alloc>> _lfuPart;
+    RemovalNotifier<Key, Value> _notifier;
 };
\ No newline at end of file
@@ -1,113 +1,154 @@
 #pragma once
 
-#include "ArcNode.h"
+#include "CacheLocking.h"
+#include "GhostTable.h"
+#include "NodeStorage.h"
+#include "RemovalListener.h"
+#include <functional>
 #include <unordered_map>
 #include <map>
-#include <list>
 #include <mutex>
 
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>>
 class ArcLfuPart{
 public:
-    using NodeType = ArcNode<Key, Value>;
-    using NodePtr = std::shared_ptr<NodeType>;
-    using NodeMap = std::unordered_map<Key, NodePtr>;
-    using FreMap = std::map<size_t, std::list<NodePtr>>;
-
-    explicit ArcLfuPart(size_t capacity, size_t transformThreshold)
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex, std::hash<Key>, std::equal_to<Key>,
+                                       RebindAlloc<Alloc, std::pair<const Key, NodeIndex>>>;
+    // 频次 -> 该频次的侵入式链表
+    using FreMap = std::map<size_t, typename Storage::List, std::less<size_t>,
+                            RebindAlloc<Alloc, std::pair<const size_t, typename Storage::List>>>;
+
+    explicit ArcLfuPart(size_t capacity, size_t transformThreshold, const Alloc& alloc = Alloc())
         : capacity_(capacity)
         , ghostCapacity_(capacity)
         , transformThreshold_(transformThreshold)
         , minFreq_(0)
-    {
-        initializeLists();
-    }
+        , mainCache_(alloc)
+        , freMap_(alloc)
+        , storage_(capacity, alloc)
+        , ghost_(capacity, alloc)
+    {}
 
     bool put(Key key, const Value& value) {
         if (capacity_ == 0) return false;
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = mainCache_.find(key);
-        if (it != mainCache_.end()) 
+        bool result;
         {
-            return updateExistingNode(it->second, value);
+            std::lock_guard<Mutex> lock(mutex_);
+            auto it = mainCache_.find(key);
+            if (it != mainCache_.end()) 
+            {
+                result = updateExistingNode(it->second, value);
+            }
+            else
+            {
+                result = addNewNode(key, value);
+            }
         }
-        return addNewNode(key, value);
+        notifier_.dispatch();
+        return result;
+    }
+
+    // 只读查询, 不更新访问频次
+    bool peek(Key key, Value& value) {
+        std::lock_guard<Mutex> lock(mutex_);
+        auto it = mainCache_.find(key);
+        if (it == mainCache_.end()) return false;
+        value = storage_.value(it->second);
+        return true;
     }
 
     bool get(Key key, Value& value) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<Mutex> lock(mutex_);
         auto it = mainCache_.find(key);
         if (it != mainCache_.end()) 
         {
             updateNodeFrequency(it->second);
-            value = it->second->getValue();
+            value = storage_.value(it->second);
             return true;
         }
         return false;       
     }
 
     bool contain(Key key) {
+        std::lock_guard<Mutex> lock(mutex_);
         return mainCache_.find(key) != mainCache_.end();
     }
 
     bool checkGhost(Key key) {
-        auto it = ghostCache_.find(key);
-        if (it != ghostCache_.end()) 
-        {
-            removeFromGhost(it->second);
-            ghostCache_.erase(it);
-            return true;
-        }
-        return false;
+        std::lock_guard<Mutex> lock(mutex_);
+        return ghost_.erase(std::hash<Key>{}(key));
     }
 
-    void increaseCapacity() { ++capacity_; }
+    void increaseCapacity() {
+        std::lock_guard<Mutex> lock(mutex_);
+        ++capacity_;
+    }
 
     bool decreaseCapacity() {
-        if (capacity_ <= 0) return false;
-        if (mainCache_.size() == capacity_) 
         {
-            evictLeastFrequent();
+            std::lock_guard<Mutex> lock(mutex_);
+            if (capacity_ <= 0) return false;
+            if (mainCache_.size() == capacity_) 
+            {
+                evictLeastFrequent();
+            }
+            --capacity_;
         }
-        --capacity_;
+        notifier_.dispatch();
         return true;
     }
 
-private:
-    void initializeLists() {
-        ghostHead_ = std::make_shared<NodeType>();
-        ghostTail_ = std::make_shared<NodeType>();
-        ghostHead_->_next = ghostTail_;
-        ghostTail_->_prev = ghostHead_;
+    // 后台维护: 主存淘汰到 lowWatermark * 容量, 幽灵链表裁剪到 lowWatermark * 幽灵容量
+    size_t maintain(size_t budget, double lowWatermark) {
+        size_t done = 0;
+        {
+            std::lock_guard<Mutex> lock(mutex_);
+            while (done < budget && !mainCache_.empty() && mainCache_.size() > capacity_ * lowWatermark) {
+                evictLeastFrequent();
+                ++done;
+            }
+            while (done < budget && !ghost_.empty() && ghost_.size() > ghostCapacity_ * lowWatermark) {
+                ghost_.popOldest();
+                ++done;
+            }
+        }
+        notifier_.dispatch();
+        return done;
+    }
+
+    // 主存淘汰(移入幽灵链表)时的通知, 由 ArcCahce 过滤后转交给用户
+    void setRemovalListener(typename RemovalNotifier<Key, Value>::Listener listener, size_t batchSize) {
+        notifier_.setListener(std::move(listener), batchSize);
     }
+    void flushRemovals() {notifier_.flush();}
 
-    bool updateExistingNode(NodePtr node, const Value& value) {
-        node->setValue(value);
+private:
+    bool updateExistingNode(NodeIndex node, const Value& value) {
+        storage_.value(node) = value;
         updateNodeFrequency(node);
         return true;
     }
 
     bool addNewNode(const Key& key, const Value& value) {
         if (capacity_ == mainCache_.size()) evictLeastFrequent();
-        NodePtr newNode = std::make_shared<NodeType>(key, value);
+        NodeIndex newNode = storage_.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
         mainCache_[key] = newNode;
         // 将新节点添加到频率为1的列表中
-        if (freMap_.find(1) == freMap_.end()) 
-        {
-            freMap_[1] = std::list<NodePtr>();
-        }
-        freMap_[1].push_back(newNode);
+        storage_.pushBack(freMap_[1], newNode);
         minFreq_ = 1;
         return true;
     }
 
-    void updateNodeFrequency(NodePtr node) {
-        size_t oldFreq = node->getAccessCount();
-        node->incrementAccessCount();
-        size_t newFreq = node->getAccessCount();
+    void updateNodeFrequency(NodeIndex node) {
+        uint32_t& accessCount = storage_.link(node).count;
+        size_t oldFreq = accessCount;
+        ++accessCount;
+        size_t newFreq = accessCount;
 
         auto& oldList = freMap_[oldFreq];
-        oldList.remove(node);
+        storage_.unlink(oldList, node);
 
         if (oldList.empty()) 
         {
@@ -119,11 +160,7 @@ private:
         }
 
         // 添加到新频率列表
-        if (freMap_.find(newFreq) == freMap_.end()) 
-        {
-            freMap_[newFreq] = std::list<NodePtr>();
-        }
-        freMap_[newFreq].push_back(node);
+        storage_.pushBack(freMap_[newFreq], node);
     }
 
     void evictLeastFrequent() {
@@ -132,8 +169,10 @@ private:
         auto& minFreqList = freMap_[minFreq_];
         if (minFreqList.empty()) return;
         
-        NodePtr leastNode = minFreqList.front();
-        minFreqList.pop_front();
+        NodeIndex leastNode = minFreqList.head;
+        storage_.unlink(minFreqList, leastNode);
+        if (notifier_.enabled())
+            notifier_.record(storage_.key(leastNode), storage_.value(leastNode), RemovalCause::Capacity);
 
         if (minFreqList.empty()) 
         {
@@ -145,55 +184,28 @@ private:
             }
         }    
 
-        // 将节点移到幽灵缓存
-        if (ghostCache_.size() == ghostCapacity_) 
+        // 将键的指纹移到幽灵缓存
+        if (ghost_.size() >= ghostCapacity_) 
         {
-            removeOldestGhost();
+            ghost_.popOldest();
         }
-        addToGhost(leastNode);
+        ghost_.insert(std::hash<Key>{}(storage_.key(leastNode)));
         
         // 从主缓存中移除
-        mainCache_.erase(leastNode->getKey());
-    }
-
-    void removeFromGhost(NodePtr node) {
-        if (!node->_prev.expired() && node->_next) {
-            auto pre = node->_prev.lock();
-            pre->_next = node->_next;
-            node->_next->_prev = node->_prev;
-            node->_next = nullptr;
-        }
-    }
-
-    void addToGhost(NodePtr node) {
-        node->_next = ghostTail_;
-        node->_prev = ghostTail_->_prev;
-
-        if (!ghostTail_->_prev.expired()) {
-            ghostTail_->_prev.lock()->_next = node;
-        }
-        ghostTail_->_prev = node;
-        ghostCache_[node->getKey()] = node;
-    }
-
-    void removeOldestGhost() {
-        NodePtr oldestGhost = ghostHead_->_next;
-        if (oldestGhost != ghostTail_) {
-            removeFromGhost(oldestGhost);
-            ghostCache_.erase(oldestGhost->getKey());
-        }
+        mainCache_.erase(storage_.key(leastNode));
+        storage_.release(leastNode);
     }
 private:
     size_t capacity_;
     size_t ghostCapacity_;
     size_t transformThreshold_;
     size_t minFreq_;
-    std::mutex mutex_;
+    Mutex mutex_;
 
     NodeMap mainCache_;
-    NodeMap ghostCache_;
     FreMap freMap_;
 
-    NodePtr ghostHead_;
-    NodePtr ghostTail_;
+    Storage storage_;
+    GhostTable<Alloc> ghost_;
+    RemovalNotifier<Key, Value> notifier_;
 };
\ No newline at end of file
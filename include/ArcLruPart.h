@@ -1,39 +1,64 @@
 #pragma once
 
-#include "ArcNode.h"
+#include "CacheLocking.h"
+#include "GhostTable.h"
+#include "NodeStorage.h"
+#include "RemovalListener.h"
+#include <functional>
 #include <unordered_map>
-#include <map>
 #include <mutex>
 
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>>
 class ArcLruPart{
 public:
-    using NodeType = ArcNode<Key, Value>;
-    using NodePtr = std::shared_ptr<NodeType>;
-    using NodeMap = std::unordered_map<Key, NodePtr>;
-    explicit ArcLruPart(size_t capacity, size_t transformThreshold)
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex, std::hash<Key>, std::equal_to<Key>,
+                                       RebindAlloc<Alloc, std::pair<const Key, NodeIndex>>>;
+    explicit ArcLruPart(size_t capacity, size_t transformThreshold, const Alloc& alloc = Alloc())
         : _capacity(capacity)
-        , _ghostCapacity(capacity)
         , _transformThreshold(transformThreshold)
-    {
-        initializeLists();
-    }
+        , _ghostCapacity(capacity)
+        , _mainCache(alloc)
+        , _storage(capacity, alloc)
+        , _ghost(capacity, alloc)
+    {}
 
     bool put(Key _key,const Value& _value){
         if (_capacity == 0) return false;
-        std::lock_guard<std::mutex> lock(_mutex);
-        auto it = _mainCache.find(_key);
-        if (it != _mainCache.end()) {
-            return updateExistingNode(it->second, _value);
+        bool result;
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            auto it = _mainCache.find(_key);
+            if (it != _mainCache.end()) {
+                result = updateExistingNode(it->second, _value);
+            } else {
+                result = addNode(_key, _value);
+            }
         }
-        return addNode(_key, _value);
+        _notifier.dispatch();
+        return result;
+    }
+
+    // 只读查询, 不更新访问信息
+    bool peek(Key key, Value& value) {
+        std::lock_guard<Mutex> lock(_mutex);
+        auto it = _mainCache.find(key);
+        if (it == _mainCache.end()) return false;
+        value = _storage.value(it->second);
+        return true;
+    }
+
+    bool contain(Key key) {
+        std::lock_guard<Mutex> lock(_mutex);
+        return _mainCache.find(key) != _mainCache.end();
     }
 
     bool get(Key _key, Value& _value, bool& shouldTransform) {
-        std::lock_guard<std::mutex> lock(_mutex);
+        std::lock_guard<Mutex> lock(_mutex);
         auto it = _mainCache.find(_key);
         if (it != _mainCache.end()) {
-            _value = it->second->getValue();
+            _value = _storage.value(it->second);
             shouldTransform = updateNodeAccess(it->second);
             return true;
         }
@@ -41,137 +66,109 @@ public:
     }
 
     bool checkGhost(Key key) {
-        auto it = _ghostCache.find(key);
-        if (it != _ghostCache.end()) {
-            removeFromGhost(it->second);
-            _ghostCache.erase(it);
-            return true;
-        }
-        return false;
+        std::lock_guard<Mutex> lock(_mutex);
+        return _ghost.erase(std::hash<Key>{}(key));
     }
 
-    void increaseCapacity() {++_capacity;}
+    void increaseCapacity() {
+        std::lock_guard<Mutex> lock(_mutex);
+        ++_capacity;
+    }
 
     bool decreaseCapacity() {
-        if (_capacity <= 0) return false;
-        if (_mainCache.size() == _capacity) {
-             evictLeastRecent();
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            if (_capacity <= 0) return false;
+            if (_mainCache.size() == _capacity) {
+                 evictLeastRecent();
+            }
+            --_capacity;
         }
-        --_capacity;
+        _notifier.dispatch();
         return true;
     }
 
-private:
-    void initializeLists() 
-    {
-        _mainHead = std::make_shared<NodeType>();
-        _mainTail = std::make_shared<NodeType>();
-        _mainHead->_next = _mainTail;
-        _mainTail->_prev = _mainHead;
+    // 后台维护: 主存淘汰到 lowWatermark * 容量, 幽灵链表裁剪到 lowWatermark * 幽灵容量
+    size_t maintain(size_t budget, double lowWatermark) {
+        size_t done = 0;
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            while (done < budget && !_mainCache.empty() && _mainCache.size() > _capacity * lowWatermark) {
+                evictLeastRecent();
+                ++done;
+            }
+            while (done < budget && !_ghost.empty() && _ghost.size() > _ghostCapacity * lowWatermark) {
+                _ghost.popOldest();
+                ++done;
+            }
+        }
+        _notifier.dispatch();
+        return done;
+    }
 
-        _ghostHead = std::make_shared<NodeType>();
-        _ghostTail = std::make_shared<NodeType>();
-        _ghostHead->_next = _ghostTail;
-        _ghostTail->_prev = _ghostHead;
+    // 主存淘汰(移入幽灵链表)时的通知, 由 ArcCahce 过滤后转交给用户
+    void setRemovalListener(typename RemovalNotifier<Key, Value>::Listener listener, size_t batchSize) {
+        _notifier.setListener(std::move(listener), batchSize);
     }
+    void flushRemovals() {_notifier.flush();}
 
-    bool updateExistingNode(NodePtr node, const Value& value) {
-        node->setValue(value);
+private:
+    bool updateExistingNode(NodeIndex node, const Value& value) {
+        _storage.value(node) = value;
         moveToFront(node);
         return true;
     }
 
     bool addNode(const Key& key, const Value& value) {
         if (_capacity == _mainCache.size()) evictLeastRecent();
-        NodePtr tempNode = std::make_shared<NodeType> (key, value);
+        NodeIndex tempNode = _storage.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
         _mainCache[key] = tempNode;
         addToFront(tempNode);
         return true;
     }
 
-    bool updateNodeAccess(NodePtr node) {
-        node->incrementAccessCount();
+    bool updateNodeAccess(NodeIndex node) {
+        uint32_t& accessCount = _storage.link(node).count;
+        ++accessCount;
         moveToFront(node);
-        return node->getAccessCount() >= _transformThreshold;
+        return accessCount >= _transformThreshold;
     }
 
-    void moveToFront(NodePtr node) {
-        if (!node->_prev.expired() && node->_next) {
-            auto prev = node->_prev.lock();
-            prev->_next = node->_next;
-            node->_next->_prev = node->_prev;
-            node->_next = nullptr;
-        }
-        addToFront(node);
+    void moveToFront(NodeIndex node) {
+        _storage.moveToFront(_mainList, node);
     }
 
-    void addToFront(NodePtr node) {
-        node->_next = _mainHead->_next;
-        _mainHead->_next->_prev = node;
-        _mainHead->_next = node;
-        node->_prev = _mainHead;
+    void addToFront(NodeIndex node) {
+        _storage.pushFront(_mainList, node);
     }
 
     void evictLeastRecent() {
-        NodePtr leastRecent = _mainTail->_prev.lock();
-        if (!leastRecent || leastRecent == _mainHead) return;
+        NodeIndex leastRecent = _mainList.tail;
+        if (leastRecent == Storage::npos) return;
+        if (_notifier.enabled())
+            _notifier.record(_storage.key(leastRecent), _storage.value(leastRecent), RemovalCause::Capacity);
         removeFromMain(leastRecent);
-        if (_ghostCache.size() >= _ghostCapacity) removeOldestGhost();
-        addToGhost(leastRecent);
-        _mainCache.erase(leastRecent->getKey());
-    }
-
-     void removeFromMain(NodePtr node) 
-    {
-        if (!node->_prev.expired() && node->_next) {
-            auto prev = node->_prev.lock();
-            prev->_next = node->_next;
-            node->_next->_prev = node->_prev;
-            node->_next = nullptr; // 清空指针，防止悬垂引用
-        }
+        // 幽灵链表只记录键的指纹, 节点本身立即归还
+        if (_ghost.size() >= _ghostCapacity) _ghost.popOldest();
+        _ghost.insert(std::hash<Key>{}(_storage.key(leastRecent)));
+        _mainCache.erase(_storage.key(leastRecent));
+        _storage.release(leastRecent);
     }
 
-    void removeFromGhost(NodePtr node) 
+    void removeFromMain(NodeIndex node) 
     {
-        if (!node->_prev.expired() && node->_next) {
-            auto prev = node->_prev.lock();
-            prev->_next = node->_next;
-            node->_next->_prev = node->_prev;
-            node->_next = nullptr; // 清空指针，防止悬垂引用
-        }
-    }
-
-    void addToGhost(NodePtr node) 
-    {
-        node->_next = _ghostTail;
-        node->_prev = _ghostTail->_prev;
-        if (!_ghostTail->_prev.expired()) {
-            _ghostTail->_prev.lock()->_next = node;
-        }
-        _ghostTail->_prev= node;
-        _ghostCache[node->getKey()] = node;
+        _storage.unlink(_mainList, node);
     }
-    void removeOldestGhost() 
-    {
-        NodePtr oldestGhost = _ghostHead->_next;
-        if (oldestGhost != _ghostTail) 
-        {
-            removeFromGhost(oldestGhost);
-            _ghostCache.erase(oldestGhost->getKey());
-        }
-    } 
 private:
     size_t _capacity;
     size_t _transformThreshold;
     size_t _ghostCapacity;
     
-    std::mutex _mutex;
+    Mutex _mutex;
     NodeMap _mainCache;
-    NodeMap _ghostCache;
-
-    NodePtr _mainHead;
-    NodePtr _mainTail;
 
-    NodePtr _ghostHead;
-    NodePtr _ghostTail;
+    Storage _storage;
+    typename Storage::List _mainList;  // 头部为最近访问
+    GhostTable<Alloc> _ghost;
+    RemovalNotifier<Key, Value> _notifier;
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+// 缓存内部容器统一从 Alloc 重新绑定出各自的分配器, 默认 std::allocator<char>
+template<typename Alloc, typename T>
+using RebindAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+// 一个缓存(或一组缓存)的分配统计
+struct AllocationStats{
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> peakBytes{0};
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> deallocations{0};
+
+    void onAllocate(size_t bytes) {
+        size_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        size_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+    void onDeallocate(size_t bytes) {
+        liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// 计数分配器: 记录经过它的字节数与分配次数, 实际分配交给 operator new
+// 重新绑定后的分配器共用同一个 AllocationStats, 因此一个缓存内所有容器的开销汇总在一起
+template<typename T>
+class CountingAllocator{
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(AllocationStats* stats) noexcept : _stats(stats) {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept : _stats(other.stats()) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        T* p;
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            p = static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+        else
+            p = static_cast<T*>(::operator new(bytes));
+        _stats->onAllocate(bytes);
+        return p;
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        _stats->onDeallocate(n * sizeof(T));
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        else
+            ::operator delete(p);
+    }
+
+    AllocationStats* stats() const noexcept {return _stats;}
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept {return _stats == other.stats();}
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>& other) const noexcept {return _stats != other.stats();}
+
+private:
+    AllocationStats* _stats;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+
+// Cache<> 的淘汰策略, 统一接口:
+//   Node* insert(key, value)  新建节点并加入淘汰队列
+//   void  touch(node)         命中后更新节点位置
+//   Node* victim()            最应被淘汰的节点(仍在队列中)
+//   void  erase(node)         从队列摘除并释放节点
+//   kConcurrentTouch          touch 能否在共享锁下并发调用
+// 节点使用裸指针侵入式链表, 不再有 shared_ptr 控制块与引用计数开销
+
+struct EvictionLink{
+    EvictionLink* prev = this;
+    EvictionLink* next = this;
+
+    void unlink() {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = this;
+    }
+    // 插入到 pos 之前
+    void insertBefore(EvictionLink* pos) {
+        prev = pos->prev;
+        next = pos;
+        pos->prev->next = this;
+        pos->prev = this;
+    }
+    bool empty() const {return next == this;}
+};
+
+template<typename Key, typename Value>
+class LruEviction{
+public:
+    struct Node : EvictionLink{
+        Node(const Key& k, const Value& v): key(k), value(v) {}
+        Key key;
+        Value value;
+    };
+    static constexpr bool kConcurrentTouch = false;
+
+    LruEviction() = default;
+    LruEviction(const LruEviction&) = delete;
+    LruEviction& operator=(const LruEviction&) = delete;
+    ~LruEviction() {
+        while (!_head.empty()) erase(static_cast<Node*>(_head.next));
+    }
+
+    Node* insert(const Key& key, const Value& value) {
+        Node* node = new Node(key, value);
+        node->insertBefore(&_head);
+        return node;
+    }
+    void touch(Node* node) {
+        node->unlink();
+        node->insertBefore(&_head);
+    }
+    Node* victim() {
+        return _head.empty() ? nullptr : static_cast<Node*>(_head.next);
+    }
+    void erase(Node* node) {
+        node->unlink();
+        delete node;
+    }
+private:
+    EvictionLink _head; // head.next 为最久未访问, head.prev 为最近访问
+};
+
+template<typename Key, typename Value>
+class LfuEviction{
+public:
+    struct Node : EvictionLink{
+        Node(const Key& k, const Value& v): key(k), value(v), freq(1) {}
+        Key key;
+        Value value;
+        size_t freq;
+    };
+    static constexpr bool kConcurrentTouch = false;
+
+    LfuEviction() = default;
+    LfuEviction(const LfuEviction&) = delete;
+    LfuEviction& operator=(const LfuEviction&) = delete;
+    ~LfuEviction() {
+        while (Node* node = victim()) erase(node);
+    }
+
+    Node* insert(const Key& key, const Value& value) {
+        Node* node = new Node(key, value);
+        node->insertBefore(&_buckets[1]);
+        return node;
+    }
+    void touch(Node* node) {
+        size_t oldFreq = node->freq;
+        node->unlink();
+        ++node->freq;
+        node->insertBefore(&_buckets[node->freq]);
+        auto it = _buckets.find(oldFreq);
+        if (it->second.empty()) _buckets.erase(it);
+    }
+    // 频次最低的桶中最早进入的节点
+    Node* victim() {
+        return _buckets.empty() ? nullptr : static_cast<Node*>(_buckets.begin()->second.next);
+    }
+    void erase(Node* node) {
+        size_t freq = node->freq;
+        node->unlink();
+        delete node;
+        auto it = _buckets.find(freq);
+        if (it->second.empty()) _buckets.erase(it);
+    }
+private:
+    std::map<size_t, EvictionLink> _buckets; // 频次 -> 该频次链表哨兵, begin() 即最小频次
+};
+
+// CLOCK(二次机会): 命中只置位引用位, 可以在读锁下并发执行
+template<typename Key, typename Value>
+class ClockEviction{
+public:
+    struct Node : EvictionLink{
+        Node(const Key& k, const Value& v): key(k), value(v), referenced(false) {}
+        Key key;
+        Value value;
+        std::atomic<bool> referenced;
+    };
+    static constexpr bool kConcurrentTouch = true;
+
+    ClockEviction() = default;
+    ClockEviction(const ClockEviction&) = delete;
+    ClockEviction& operator=(const ClockEviction&) = delete;
+    ~ClockEviction() {
+        while (!_ring.empty()) erase(static_cast<Node*>(_ring.next));
+    }
+
+    Node* insert(const Key& key, const Value& value) {
+        Node* node = new Node(key, value);
+        // 新节点放在指针之前, 即最后才会被扫到的位置
+        node->insertBefore(_hand == nullptr ? &_ring : _hand);
+        if (_hand == nullptr) _hand = node;
+        return node;
+    }
+    void touch(Node* node) {
+        if (!node->referenced.load(std::memory_order_relaxed))
+            node->referenced.store(true, std::memory_order_relaxed);
+    }
+    Node* victim() {
+        if (_ring.empty()) return nullptr;
+        while (true) {
+            if (_hand == &_ring) _hand = _ring.next;
+            Node* node = static_cast<Node*>(_hand);
+            if (!node->referenced.load(std::memory_order_relaxed)) return node;
+            node->referenced.store(false, std::memory_order_relaxed);
+            _hand = _hand->next;
+        }
+    }
+    void erase(Node* node) {
+        if (_hand == node) _hand = node->next;
+        node->unlink();
+        delete node;
+        if (_ring.empty()) _hand = nullptr;
+    }
+private:
+    EvictionLink _ring;
+    EvictionLink* _hand = nullptr;
+};
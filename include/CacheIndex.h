@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+// Cache<> 的索引策略: key -> 淘汰策略节点指针
+
+template<typename Key, typename Node>
+class HashIndex{
+public:
+    Node* find(const Key& key) const {
+        auto it = _map.find(key);
+        return it == _map.end() ? nullptr : it->second;
+    }
+    void insert(const Key& key, Node* node) {_map[key] = node;}
+    void erase(const Key& key) {_map.erase(key);}
+    void reserve(size_t n) {_map.reserve(n);}
+    size_t size() const {return _map.size();}
+private:
+    std::unordered_map<Key, Node*> _map;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+
+// Cache<> 的加锁策略
+// kStripes: 分段数量(>1 时缓存按 key 的哈希切成多个独立分段, 每段一把锁)
+// ReadGuard / WriteGuard: 读路径与写路径使用的守卫类型
+
+// 空互斥量, 满足 Lockable / SharedLockable, 所有操作均为空
+struct NullMutex{
+    void lock() {}
+    bool try_lock() {return true;}
+    void unlock() {}
+    void lock_shared() {}
+    bool try_lock_shared() {return true;}
+    void unlock_shared() {}
+};
+
+// 不加锁: 单线程或线程独占的缓存
+struct NoLocking{
+    static constexpr size_t kStripes = 1;
+    using Mutex = NullMutex;
+    struct ReadGuard{
+        explicit ReadGuard(Mutex&) {}
+    };
+    using WriteGuard = ReadGuard;
+};
+
+// 单把互斥锁, 与 LruCache / LfuCache 的行为一致
+struct MutexLocking{
+    static constexpr size_t kStripes = 1;
+    using Mutex = std::mutex;
+    using ReadGuard = std::lock_guard<std::mutex>;
+    using WriteGuard = std::lock_guard<std::mutex>;
+};
+
+// 分段锁: 与 HashLruCache 一样按哈希分片, 但分片在编译期确定, 没有额外的指针间接
+template<size_t N = 16>
+struct StripedLocking{
+    static_assert(N > 0, "StripedLocking needs at least one stripe");
+    static constexpr size_t kStripes = N;
+    using Mutex = std::mutex;
+    using ReadGuard = std::lock_guard<std::mutex>;
+    using WriteGuard = std::lock_guard<std::mutex>;
+};
+
+// 读写锁: 只有当淘汰策略的 touch 可以并发执行时(如 ClockEviction), get 才走共享锁
+struct RWLocking{
+    static constexpr size_t kStripes = 1;
+    using Mutex = std::shared_mutex;
+    using ReadGuard = std::shared_lock<std::shared_mutex>;
+    using WriteGuard = std::unique_lock<std::shared_mutex>;
+};
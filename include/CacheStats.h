@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Cache<> 的统计策略
+
+// 不统计: 所有回调都是空内联函数, 编译后不产生任何代码
+struct NoStats{
+    void onHit() {}
+    void onMiss() {}
+    void onPut() {}
+    void onEvict() {}
+};
+
+// 计数统计: relaxed 原子计数, 多线程下也可以直接使用
+class CountingStats{
+public:
+    void onHit() {_hits.fetch_add(1, std::memory_order_relaxed);}
+    void onMiss() {_misses.fetch_add(1, std::memory_order_relaxed);}
+    void onPut() {_puts.fetch_add(1, std::memory_order_relaxed);}
+    void onEvict() {_evictions.fetch_add(1, std::memory_order_relaxed);}
+
+    uint64_t hits() const {return _hits.load(std::memory_order_relaxed);}
+    uint64_t misses() const {return _misses.load(std::memory_order_relaxed);}
+    uint64_t puts() const {return _puts.load(std::memory_order_relaxed);}
+    uint64_t evictions() const {return _evictions.load(std::memory_order_relaxed);}
+    double hitRate() const {
+        uint64_t total = hits() + misses();
+        return total == 0 ? 0.0 : static_cast<double>(hits()) / total;
+    }
+private:
+    std::atomic<uint64_t> _hits{0};
+    std::atomic<uint64_t> _misses{0};
+    std::atomic<uint64_t> _puts{0};
+    std::atomic<uint64_t> _evictions{0};
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "caChePolicy.h"
+#include "Lz4Codec.h"
+
+struct CompressionOptions{
+    size_t threshold = 1024;   // 小于该大小的值不压缩
+    double maxRatio = 0.9;     // 压缩后超过原大小的该比例时改为原样存储
+    size_t probeBytes = 4096;  // 先试压缩开头这么多字节, 压不下去就整体跳过; 0 表示不试探
+};
+
+// 值压缩层: 挂在 LruCache / HashLruCache 这类 <Key, std::string> 缓存之上
+// 写入时超过阈值的值用 LZ4 块格式压缩, 内层缓存保存编码后的字节串, 并通过 setWeigher 按编码后的
+// 字节数限制容量. 编码格式: 1 字节标记(0 原样, 1 压缩), 压缩时后跟 4 字节原始长度.
+// 读取时解压到调用方提供的缓冲区, 或解压到 std::string.
+template<typename Key, typename Cache>
+class CompressedCache : public caChepolicy<Key, std::string>{
+public:
+    struct Stats{
+        std::atomic<size_t> compressed{0};   // 压缩存储的值个数
+        std::atomic<size_t> stored{0};       // 原样存储的值个数
+        std::atomic<size_t> skipped{0};      // 其中因试探或压缩率不够而放弃压缩的个数
+        std::atomic<size_t> rawBytes{0};     // 写入的原始字节数
+        std::atomic<size_t> encodedBytes{0}; // 编码后的字节数
+    };
+
+    CompressedCache(Cache& cache, size_t byteCapacity, const CompressionOptions& options = CompressionOptions())
+    : _cache(cache)
+    , _options(options)
+    {
+        _cache.setWeigher(byteCapacity, [](const Key&, const std::string& blob) {return blob.size();});
+    }
+    ~CompressedCache() override = default;
+
+    void put(Key key, const std::string& value) override {
+        std::string& blob = scratch();
+        encode(value, blob);
+        _cache.put(key, blob);
+    }
+
+    bool get(Key key, std::string& value) override {
+        std::string& blob = scratch();
+        if (!_cache.get(key, blob)) return false;
+        size_t length = decodedLength(blob);
+        value.resize(length);
+        return decode(blob, &value[0], length) == length;
+    }
+
+    std::string get(Key key) override {
+        std::string value;
+        get(key, value);
+        return value;
+    }
+
+    // 解压到调用方的缓冲区, length 返回值的长度; 缓冲区不够时返回 false, length 为所需大小
+    bool get(Key key, char* buffer, size_t capacity, size_t& length) {
+        std::string& blob = scratch();
+        length = 0;
+        if (!_cache.get(key, blob)) return false;
+        length = decodedLength(blob);
+        if (length > capacity) return false;
+        return decode(blob, buffer, capacity) == length;
+    }
+
+    const Stats& stats() const {return _stats;}
+
+private:
+    enum : uint8_t {kRaw = 0, kLz4 = 1};
+    static constexpr size_t kHeader = 1 + sizeof(uint32_t);
+
+    // 每个线程复用一个编码缓冲区, 避免每次读写都分配
+    static std::string& scratch() {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+    void encode(const std::string& value, std::string& blob) {
+        _stats.rawBytes.fetch_add(value.size(), std::memory_order_relaxed);
+        if (value.size() >= _options.threshold && value.size() <= UINT32_MAX && worthCompressing(value)) {
+            blob.resize(kHeader + lz4::compressBound(value.size()));
+            size_t size = lz4::compress(value.data(), value.size(), &blob[kHeader]);
+            if (size <= value.size() * _options.maxRatio) {
+                blob[0] = static_cast<char>(kLz4);
+                uint32_t length = static_cast<uint32_t>(value.size());
+                std::memcpy(&blob[1], &length, sizeof(length));
+                blob.resize(kHeader + size);
+                _stats.compressed.fetch_add(1, std::memory_order_relaxed);
+                _stats.encodedBytes.fetch_add(blob.size(), std::memory_order_relaxed);
+                return;
+            }
+            _stats.skipped.fetch_add(1, std::memory_order_relaxed);
+        }
+        blob.resize(1 + value.size());
+        blob[0] = static_cast<char>(kRaw);
+        std::memcpy(&blob[1], value.data(), value.size());
+        _stats.stored.fetch_add(1, std::memory_order_relaxed);
+        _stats.encodedBytes.fetch_add(blob.size(), std::memory_order_relaxed);
+    }
+
+    // 只压缩开头 probeBytes 字节估计压缩率, 随机数据、已压缩的图片等可以少做一次完整压缩
+    bool worthCompressing(const std::string& value) {
+        if (_options.probeBytes == 0 || value.size() <= _options.probeBytes * 2) return true;
+        char probe[lz4::compressBound(4096)];
+        size_t bytes = _options.probeBytes < 4096 ? _options.probeBytes : 4096;
+        if (lz4::compress(value.data(), bytes, probe) <= bytes * _options.maxRatio) return true;
+        _stats.skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    static size_t decodedLength(const std::string& blob) {
+        if (blob.empty()) return 0;
+        if (static_cast<uint8_t>(blob[0]) == kRaw) return blob.size() - 1;
+        uint32_t length;
+        std::memcpy(&length, &blob[1], sizeof(length));
+        return length;
+    }
+
+    static size_t decode(const std::string& blob, char* buffer, size_t capacity) {
+        if (blob.empty()) return 0;
+        if (static_cast<uint8_t>(blob[0]) == kRaw) {
+            std::memcpy(buffer, blob.data() + 1, blob.size() - 1);
+            return blob.size() - 1;
+        }
+        return lz4::decompress(blob.data() + kHeader, blob.size() - kHeader, buffer, capacity);
+    }
+
+private:
+    Cache& _cache;
+    CompressionOptions _options;
+    Stats _stats;
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "caChePolicy.h"
+#include "CacheEviction.h"
+#include "FrequencySketch.h"
+#include "RemovalListener.h"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+// 读写分离的 LFU
+// - 命中只在 FrequencySketch 上做无锁计数, get 只需要共享锁
+// - 频次链表不随每次命中调整, 而是在淘汰时惰性整理: 最低频次桶的候选节点若在 sketch 中
+//   的估计频次更高, 就把它提升到对应的桶再看下一个候选
+// - 老化(计数器与频次桶减半)由 maintain() 分片完成, 可以交给后台维护线程;
+//   没有维护线程时 put 也会顺带推进一小片, 保证老化最终完成
+template<typename Key, typename Value>
+class ConcurrentLfuCache : public caChepolicy<Key, Value>{
+public:
+    ConcurrentLfuCache(size_t capacity, int maxAverageNum = 10)
+    : _capacity(capacity)
+    , _maxAverageNum(maxAverageNum > 0 ? maxAverageNum : 1)
+    , _sketch(capacity)
+    {}
+    ConcurrentLfuCache(const ConcurrentLfuCache&) = delete;
+    ConcurrentLfuCache& operator=(const ConcurrentLfuCache&) = delete;
+    ~ConcurrentLfuCache() override {
+        for (auto& entry : _nodeMap) delete entry.second;
+    }
+
+    void put(Key key, const Value& value) override {
+        if (_capacity == 0) return;
+        size_t hash = std::hash<Key>{}(key);
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            uint8_t freq = _sketch.increment(hash);
+            auto it = _nodeMap.find(key);
+            if (it != _nodeMap.end()){
+                if (_notifier.enabled()) _notifier.record(key, it->second->value, RemovalCause::Replaced);
+                it->second->value = value;
+            } else {
+                if (_nodeMap.size() >= _capacity) kickOut();
+                Node* node = new Node(hash, key, value);
+                node->insertBefore(&_buckets[freq]);
+                _nodeMap.emplace(key, node);
+                if (_aging || agingDue()) ageStep(kInlineAgingBudget);
+            }
+        }
+        _notifier.dispatch();
+    }
+
+    bool get(Key key, Value& value) override {
+        size_t hash = std::hash<Key>{}(key);
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _nodeMap.find(key);
+        if (it == _nodeMap.end()) return false;
+        _sketch.increment(hash);
+        value = it->second->value;
+        return true;
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        this->get(key, value);
+        return value;
+    }
+
+    // 维护步骤: 先主动淘汰到低水位, 再用剩余预算推进计数器老化, 返回实际完成的工作量
+    size_t maintain(size_t budget) {
+        size_t done = 0;
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            size_t lowWatermark = static_cast<size_t>(_capacity * _lowWatermark);
+            while (done < budget && !_nodeMap.empty() && _nodeMap.size() > lowWatermark){
+                kickOut();
+                ++done;
+            }
+            if (done < budget && (_aging || agingDue())) done += ageStep(budget - done);
+        }
+        _notifier.dispatch();
+        return done;
+    }
+
+    // 低水位(容量的比例), 默认 1.0 即不主动淘汰
+    void setLowWatermark(double ratio) {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _lowWatermark = ratio;
+    }
+
+    // 移除监听器: 通知在锁内缓冲, 攒够 batchSize 条后在锁外批量投递
+    void setRemovalListener(typename RemovalNotifier<Key, Value>::Listener listener, size_t batchSize = 64) {
+        _notifier.setListener(std::move(listener), batchSize);
+    }
+    void flushRemovals() {_notifier.flush();}
+
+    size_t size() {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _nodeMap.size();
+    }
+
+private:
+    static constexpr size_t kMaxFreq = FrequencySketch::kMaxCount;
+    static constexpr size_t kInlineAgingBudget = 64;
+    static constexpr int kMaxPromotions = 8; // 单次淘汰最多惰性提升的节点数
+
+    struct Node : EvictionLink{
+        Node(size_t h, const Key& k, const Value& v): hash(h), key(k), value(v) {}
+        size_t hash;
+        Key key;
+        Value value;
+    };
+
+    bool agingDue() const {
+        return _sketch.additions() > _maxAverageNum * (_nodeMap.size() + 1);
+    }
+
+    // 返回实际处理的计数器数(加上桶拼接次数), 维护线程据此判断是否还有积压
+    size_t ageStep(size_t budget) {
+        _aging = true;
+        size_t done = 0;
+        if (_sketch.age(budget, &done)){
+            // sketch 减半完成后, 频次桶整体下移一半, 每个桶只需一次链表拼接
+            for (size_t freq = 2; freq <= kMaxFreq; ++freq) splice(_buckets[freq], _buckets[freq / 2]);
+            done += kMaxFreq - 1;
+            _aging = false;
+        }
+        return done;
+    }
+
+    void kickOut() {
+        for (int promotions = 0; ; ++promotions){
+            size_t freq = 1;
+            while (freq <= kMaxFreq && _buckets[freq].empty()) ++freq;
+            if (freq > kMaxFreq) return;
+            Node* node = static_cast<Node*>(_buckets[freq].next);
+            size_t estimate = _sketch.estimate(node->hash);
+            if (estimate > freq && promotions < kMaxPromotions){
+                node->unlink();
+                node->insertBefore(&_buckets[estimate]);
+                continue;
+            }
+            if (_notifier.enabled()) _notifier.record(node->key, node->value, RemovalCause::Capacity);
+            node->unlink();
+            _nodeMap.erase(node->key);
+            delete node;
+            return;
+        }
+    }
+
+    // 把 from 整条链表接到 to 的尾部
+    static void splice(EvictionLink& from, EvictionLink& to) {
+        if (from.empty()) return;
+        EvictionLink* first = from.next;
+        EvictionLink* last = from.prev;
+        first->prev = to.prev;
+        to.prev->next = first;
+        last->next = &to;
+        to.prev = last;
+        from.next = from.prev = &from;
+    }
+
+private:
+    size_t _capacity;
+    size_t _maxAverageNum;
+    double _lowWatermark = 1.0;
+    bool _aging = false;
+    std::shared_mutex _mutex;
+    FrequencySketch _sketch;
+    std::unordered_map<Key, Node*> _nodeMap;
+    EvictionLink _buckets[kMaxFreq + 1]; // 下标为频次, 0 号不用
+    RemovalNotifier<Key, Value> _notifier;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// 近似访问频次统计(Count-Min Sketch), 计数器为饱和的 8 位原子量, 上限 kMaxCount
+// increment / estimate 均无锁, 可在读锁下并发调用
+// 老化(所有计数器减半)可以通过 age(budget) 分片进行, 每次只处理 budget 个计数器
+class FrequencySketch{
+public:
+    static constexpr uint8_t kMaxCount = 15;
+    static constexpr int kDepth = 4;
+
+    explicit FrequencySketch(size_t expectedEntries)
+    : _width(roundUp(expectedEntries < 16 ? 16 : expectedEntries))
+    , _counters(new std::atomic<uint8_t>[_width * kDepth])
+    {
+        for (size_t i = 0; i < _width * kDepth; ++i) _counters[i].store(0, std::memory_order_relaxed);
+    }
+
+    // 返回本次增加后的估计值
+    uint8_t increment(size_t hash) {
+        uint8_t estimate = kMaxCount;
+        for (int row = 0; row < kDepth; ++row){
+            std::atomic<uint8_t>& counter = _counters[indexOf(hash, row)];
+            uint8_t cur = counter.load(std::memory_order_relaxed);
+            while (cur < kMaxCount && !counter.compare_exchange_weak(cur, cur + 1, std::memory_order_relaxed)) {}
+            uint8_t now = cur < kMaxCount ? cur + 1 : kMaxCount;
+            if (now < estimate) estimate = now;
+        }
+        _additions.fetch_add(1, std::memory_order_relaxed);
+        return estimate;
+    }
+
+    uint8_t estimate(size_t hash) const {
+        uint8_t estimate = kMaxCount;
+        for (int row = 0; row < kDepth; ++row){
+            uint8_t cur = _counters[indexOf(hash, row)].load(std::memory_order_relaxed);
+            if (cur < estimate) estimate = cur;
+        }
+        return estimate;
+    }
+
+    size_t additions() const {return _additions.load(std::memory_order_relaxed);}
+
+    // 分片老化, 从上次停下的位置继续, 返回本轮老化是否已经完成; processed 非空时写入本次处理的计数器数
+    bool age(size_t budget, size_t* processed = nullptr) {
+        size_t total = _width * kDepth;
+        size_t start = _ageCursor;
+        while (budget-- > 0 && _ageCursor < total){
+            std::atomic<uint8_t>& counter = _counters[_ageCursor++];
+            uint8_t cur = counter.load(std::memory_order_relaxed);
+            while (cur > 0 && !counter.compare_exchange_weak(cur, cur >> 1, std::memory_order_relaxed)) {}
+        }
+        if (processed) *processed = _ageCursor - start;
+        if (_ageCursor < total) return false;
+        _ageCursor = 0;
+        _additions.store(_additions.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t width() const {return _width;}
+
+private:
+    static size_t roundUp(size_t n) {
+        size_t size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+    size_t indexOf(size_t hash, int row) const {
+        // 每一行使用不同的种子重新混合, std::hash<int> 是恒等映射, 不能直接取低位
+        uint64_t h = (hash + row) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 32;
+        return row * _width + (h & (_width - 1));
+    }
+
+private:
+    size_t _width;
+    std::unique_ptr<std::atomic<uint8_t>[]> _counters;
+    std::atomic<size_t> _additions{0};
+    size_t _ageCursor = 0; // 仅由持有写锁(或维护线程)的一方推进
+};
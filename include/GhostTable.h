@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CacheAllocator.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ARC 幽灵链表: 只保存键哈希的指纹, 不保存键和值
+// 每个桶 15 个槽位, 8 位 tag 连续存放在桶的前 16 字节, 用一次 SSE2 比较筛选候选槽位,
+// 命中 tag 后再比较 16 位校验值与起始桶号; 没有 SSE2 时退化为逐字节比较.
+// 桶按 64 字节对齐, 未命中的查询通常只访问一个缓存行.
+// 桶满时线性探测到下一个桶, 并在经过的桶上累加溢出计数, 查询遇到溢出计数为 0 的桶即可停止.
+// 槽位之间用下标串成 FIFO, 最早进入的指纹最先被移出.
+template<typename Alloc = std::allocator<char>>
+class GhostTable{
+public:
+    static constexpr int kSlots = 15;
+
+    explicit GhostTable(size_t capacity, const Alloc& alloc = Alloc())
+    : _mask(bucketCount(capacity) - 1)
+    , _buckets(_mask + 1, alloc)
+    , _home((_mask + 1) * kSlots, alloc)
+    , _prev((_mask + 1) * kSlots, alloc)
+    , _next((_mask + 1) * kSlots, alloc)
+    {}
+
+    size_t size() const {return _size;}
+    bool empty() const {return _size == 0;}
+
+    bool contains(uint64_t hash) const {return find(mix(hash)) != npos;}
+
+    // 找到则移除并返回 true
+    bool erase(uint64_t hash) {
+        uint32_t slot = find(mix(hash));
+        if (slot == npos) return false;
+        remove(slot);
+        return true;
+    }
+
+    // 已存在时只把它移到 FIFO 尾部
+    void insert(uint64_t hash) {
+        uint64_t h = mix(hash);
+        uint32_t slot = find(h);
+        if (slot != npos) {
+            unlinkSlot(slot);
+            linkBack(slot);
+            return;
+        }
+        if (_size == _home.size()) popOldest();
+        size_t home = h & _mask;
+        size_t b = home;
+        int free;
+        while ((free = firstEmpty(_buckets[b])) < 0) {
+            if (_buckets[b].overflow < UINT8_MAX) ++_buckets[b].overflow;
+            b = (b + 1) & _mask;
+        }
+        Bucket& bucket = _buckets[b];
+        bucket.tags[free] = tagOf(h);
+        bucket.checks[free] = checkOf(h);
+        slot = static_cast<uint32_t>(b * kSlots + free);
+        _home[slot] = static_cast<uint32_t>(home);
+        linkBack(slot);
+        ++_size;
+    }
+
+    void popOldest() {
+        if (_head != npos) remove(_head);
+    }
+
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct alignas(64) Bucket{
+        uint8_t tags[kSlots] = {};  // 0 表示空槽
+        uint8_t overflow = 0;       // 越过本桶继续探测的条目数
+        uint16_t checks[kSlots] = {};
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket should fill exactly one cache line");
+
+    // 负载不超过约一半, 探测链很短
+    static size_t bucketCount(size_t capacity) {
+        size_t need = capacity / 8 + 1;
+        size_t n = 1;
+        while (n < need) n <<= 1;
+        return n;
+    }
+
+    // std::hash 对整数通常是恒等映射, 先打散再取各段比特
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+    static uint8_t tagOf(uint64_t h) {return static_cast<uint8_t>((h >> 56) | 0x80);}
+    static uint16_t checkOf(uint64_t h) {return static_cast<uint16_t>(h >> 32);}
+
+    // tag 与给定值相等的槽位掩码
+    static unsigned matchTags(const Bucket& bucket, uint8_t tag) {
+#if defined(__SSE2__)
+        __m128i tags = _mm_load_si128(reinterpret_cast<const __m128i*>(bucket.tags));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8(static_cast<char>(tag)))));
+        return mask & ((1u << kSlots) - 1);
+#else
+        unsigned mask = 0;
+        for (int i = 0; i < kSlots; ++i)
+            if (bucket.tags[i] == tag) mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+    static int firstEmpty(const Bucket& bucket) {
+        unsigned mask = matchTags(bucket, 0);
+        return mask ? __builtin_ctz(mask) : -1;
+    }
+
+    uint32_t find(uint64_t h) const {
+        size_t home = h & _mask;
+        uint8_t tag = tagOf(h);
+        uint16_t check = checkOf(h);
+        size_t b = home;
+        for (size_t probes = 0; probes <= _mask; ++probes) {
+            const Bucket& bucket = _buckets[b];
+            for (unsigned mask = matchTags(bucket, tag); mask; mask &= mask - 1) {
+                int i = __builtin_ctz(mask);
+                uint32_t slot = static_cast<uint32_t>(b * kSlots + i);
+                if (bucket.checks[i] == check && _home[slot] == home) return slot;
+            }
+            if (bucket.overflow == 0) break;
+            b = (b + 1) & _mask;
+        }
+        return npos;
+    }
+
+    void remove(uint32_t slot) {
+        size_t b = slot / kSlots;
+        for (size_t i = _home[slot]; i != b; i = (i + 1) & _mask) {
+            // 饱和的计数无法还原, 保持不变(只会让查询多探测几个桶)
+            if (_buckets[i].overflow < UINT8_MAX) --_buckets[i].overflow;
+        }
+        _buckets[b].tags[slot % kSlots] = 0;
+        unlinkSlot(slot);
+        --_size;
+    }
+
+    void linkBack(uint32_t slot) {
+        _prev[slot] = _tail;
+        _next[slot] = npos;
+        if (_tail != npos) _next[_tail] = slot;
+        else _head = slot;
+        _tail = slot;
+    }
+
+    void unlinkSlot(uint32_t slot) {
+        if (_prev[slot] != npos) _next[_prev[slot]] = _next[slot];
+        else _head = _next[slot];
+        if (_next[slot] != npos) _prev[_next[slot]] = _prev[slot];
+        else _tail = _prev[slot];
+    }
+
+private:
+    size_t _mask;
+    std::vector<Bucket, RebindAlloc<Alloc, Bucket>> _buckets;
+    // 以下为冷数据, 只在 tag 命中或增删时访问
+    std::vector<uint32_t, RebindAlloc<Alloc, uint32_t>> _home;
+    std::vector<uint32_t, RebindAlloc<Alloc, uint32_t>> _prev;
+    std::vector<uint32_t, RebindAlloc<Alloc, uint32_t>> _next;
+    uint32_t _head = npos;
+    uint32_t _tail = npos;
+    size_t _size = 0;
+};
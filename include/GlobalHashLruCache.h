@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "caChePolicy.h"
+#include "NodeStorage.h"
+
+// 共享全局容量的分片 LRU
+// HashLruCache 把总容量平均切给各分片, 键分布倾斜时热分片反复淘汰而冷分片空着.
+// 这里各分片不设容量上限, 只有一个全局条目计数; 插入使总数超过容量时, 淘汰"最老的分片尾部":
+// 每次访问给节点打上全局逻辑时钟(存放在 Link::count 中), 每个分片把 LRU 端的时间戳发布到一个
+// 原子变量里, 淘汰时比较各分片的这个值即可找到全局最久未访问的条目.
+// 分片数不超过 kSampleShards 时逐个比较, 结果与不分片的 LRU 一致; 更多分片时随机抽样 kSampleShards 个.
+// 淘汰在释放本分片锁之后进行, 并发插入时总数可能短暂超出容量, 超出量不超过并发线程数.
+template<typename Key, typename Value>
+class GlobalHashLruCache : public caChepolicy<Key, Value>{
+public:
+    static constexpr int kSampleShards = 8;
+
+    GlobalHashLruCache(size_t totalCapacity, int shardNum)
+    : _capacity(totalCapacity)
+    , _shardNum(shardNum > 0 ? shardNum : 1)
+    , _shards(_shardNum)
+    {}
+    ~GlobalHashLruCache() override = default;
+
+    void put(Key key, const Value& value) override {
+        if (_capacity == 0) return;
+        Shard& shard = shardOf(key);
+        bool inserted = false;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end()) {
+                shard.storage.value(it->second) = value;
+                touch(shard, it->second);
+            } else {
+                NodeIndex node = shard.storage.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
+                shard.storage.link(node).count = tick();
+                shard.storage.pushBack(shard.lru, node);
+                shard.map[key] = node;
+                publishOldest(shard);
+                inserted = true;
+            }
+        }
+        if (inserted && _size.fetch_add(1, std::memory_order_relaxed) + 1 > _capacity) evictOldest();
+    }
+
+    bool get(Key key, Value& value) override {
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) return false;
+        touch(shard, it->second);
+        value = shard.storage.value(it->second);
+        return true;
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    size_t size() const {return _size.load(std::memory_order_relaxed);}
+
+    // 各分片当前条目数, 用于观察容量在分片之间的流动
+    std::vector<size_t> shardSizes() {
+        std::vector<size_t> sizes;
+        for (Shard& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            sizes.push_back(shard.map.size());
+        }
+        return sizes;
+    }
+
+private:
+    using Storage = NodeStorage<Key, Value>;
+    using NodeIndex = typename Storage::Index;
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    struct alignas(64) Shard{
+        std::mutex mutex;
+        Storage storage;
+        typename Storage::List lru; // 头部为最久未访问
+        std::unordered_map<Key, NodeIndex> map;
+        std::atomic<uint32_t> oldest{kEmpty}; // LRU 端节点的时间戳, 空分片为 kEmpty
+    };
+
+    Shard& shardOf(const Key& key) {return _shards[std::hash<Key>{}(key) % _shardNum];}
+
+    uint32_t tick() {return _clock.fetch_add(1, std::memory_order_relaxed) + 1;}
+
+    void touch(Shard& shard, NodeIndex node) {
+        shard.storage.link(node).count = tick();
+        bool wasOldest = shard.lru.head == node;
+        shard.storage.moveToBack(shard.lru, node);
+        if (wasOldest) publishOldest(shard);
+    }
+
+    void publishOldest(Shard& shard) {
+        uint32_t stamp = shard.lru.empty() ? kEmpty : shard.storage.link(shard.lru.head).count;
+        shard.oldest.store(stamp, std::memory_order_relaxed);
+    }
+
+    // 时钟回绕后仍按"距现在多久"比较
+    uint32_t ageOf(uint32_t stamp, uint32_t now) const {return now - stamp;}
+
+    int pickVictim() {
+        uint32_t now = _clock.load(std::memory_order_relaxed);
+        int victim = -1;
+        uint32_t oldestAge = 0;
+        int samples = _shardNum <= kSampleShards ? _shardNum : kSampleShards;
+        thread_local uint64_t seed = reinterpret_cast<uintptr_t>(&seed);
+        for (int i = 0; i < samples; ++i) {
+            int index = i;
+            if (samples < _shardNum) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                index = static_cast<int>((seed >> 33) % _shardNum);
+            }
+            uint32_t stamp = _shards[index].oldest.load(std::memory_order_relaxed);
+            if (stamp == kEmpty) continue;
+            uint32_t age = ageOf(stamp, now);
+            if (victim < 0 || age > oldestAge) {
+                victim = index;
+                oldestAge = age;
+            }
+        }
+        return victim;
+    }
+
+    void evictOldest() {
+        // 选中的分片可能在加锁前被其他线程清空, 重新选择
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            int victim = pickVictim();
+            if (victim < 0) return;
+            Shard& shard = _shards[victim];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            NodeIndex node = shard.lru.head;
+            if (node == Storage::npos) continue;
+            shard.storage.unlink(shard.lru, node);
+            shard.map.erase(shard.storage.key(node));
+            shard.storage.release(node);
+            publishOldest(shard);
+            _size.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+private:
+    size_t _capacity;
+    int _shardNum;
+    std::vector<Shard> _shards;
+    std::atomic<size_t> _size{0};
+    std::atomic<uint32_t> _clock{0};
+};
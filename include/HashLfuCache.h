@@ -4,17 +4,22 @@
 #include "LfuCache.h"
 #include <vector>
 #include <climits>
+#include <cmath>
+#include <algorithm>
 
-template<typename Key, typename Value>
+// Slice 为分片类型, 读多写少时可换成 ConcurrentLfuCache<Key, Value>
+template<typename Key, typename Value, typename Slice = LfuCache<Key, Value>>
 class HashLfuCache : public caChepolicy<Key, Value>{
 public:
-    HashLfuCache(size_t capacity, int sliceNum, int maxAverrageNum)
+    // sliceArgs 原样转交给每个分片的构造函数, 例如 LfuCache 的分配器
+    template<typename... SliceArgs>
+    HashLfuCache(size_t capacity, int sliceNum, int maxAverrageNum, const SliceArgs&... sliceArgs)
     :_totalCapacity(capacity)
     ,_sliceNum(sliceNum)
     {
         size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum));
         for (int i = 0; i < sliceNum; ++i){
-            _slicePtr.emplace_back(std::make_unique<LfuCache<Key, Value>>(sliceSize, maxAverrageNum));
+            _slicePtr.emplace_back(std::make_unique<Slice>(sliceSize, maxAverrageNum, sliceArgs...));
         }
     }
     ~HashLfuCache() override = default;
@@ -30,6 +35,24 @@ public:
         int index = Hash(_key) % _sliceNum;
         return _slicePtr[index]->get(_key);
     }
+    // 每个分片各自缓冲、各自投递, listener 需要能被多个线程同时调用
+    template<typename Listener>
+    void setRemovalListener(const Listener& listener, size_t batchSize = 64){
+        for (auto& slice : _slicePtr) slice->setRemovalListener(listener, batchSize);
+    }
+    void flushRemovals(){
+        for (auto& slice : _slicePtr) slice->flushRemovals();
+    }
+    // 维护预算平均分给各个分片
+    size_t maintain(size_t budget){
+        size_t sliceBudget = std::max<size_t>(budget / _sliceNum, 1);
+        size_t done = 0;
+        for (auto& slice : _slicePtr) done += slice->maintain(sliceBudget);
+        return done;
+    }
+    void setBackgroundAging(bool enable){
+        for (auto& slice : _slicePtr) slice->setBackgroundAging(enable);
+    }
     int Hash(Key _key){
         std::hash<Key> myhash;
         return myhash(_key);
@@ -37,5 +60,5 @@ public:
 private:
     size_t _totalCapacity;
     int _sliceNum;
-    std::vector<std::unique_ptr<LfuCache<Key, Value>>> _slicePtr;
+    std::vector<std::unique_ptr<Slice>> _slicePtr;
 };
\ No newline at end of file
@@ -4,17 +4,19 @@
 #include <vector>
 #include <thread>
 #include <cmath>
+#include <algorithm>
 
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Alloc = std::allocator<char>>
 class HashLruCache : public caChepolicy<Key, Value>{
 public:
-    HashLruCache(size_t totalCapacity_, int sliceNum_)
+    using Slice = LruCache<Key, Value, std::mutex, Alloc>;
+    HashLruCache(size_t totalCapacity_, int sliceNum_, const Alloc& alloc = Alloc())
     : totalCapacity(totalCapacity_)
     , sliceNum(sliceNum_ > 0 ? sliceNum_ : std::thread::hardware_concurrency())
     {
         size_t sliceSize = std::ceil(totalCapacity / static_cast<double>(sliceNum));
         for (int i = 0; i < sliceNum; ++i){
-            slicePtr.emplace_back(std::make_unique<LruCache<Key, Value>>(sliceSize));
+            slicePtr.emplace_back(std::make_unique<Slice>(sliceSize, alloc));
         }
     }
     bool get(Key key, Value& value) override {
@@ -30,6 +32,38 @@ public:
         size_t index = Hash(key) % sliceNum;
         slicePtr[index]->put(key, value);
     }
+    void remove(Key key) {
+        size_t index = Hash(key) % sliceNum;
+        slicePtr[index]->remove(key);
+    }
+    // 每个分片各自缓冲、各自投递, listener 需要能被多个线程同时调用
+    template<typename Listener>
+    void setRemovalListener(const Listener& listener, size_t batchSize = 64){
+        for (auto& slice : slicePtr) slice->setRemovalListener(listener, batchSize);
+    }
+    void flushRemovals(){
+        for (auto& slice : slicePtr) slice->flushRemovals();
+    }
+    // 维护预算平均分给各个分片
+    size_t maintain(size_t budget){
+        size_t sliceBudget = std::max<size_t>(budget / sliceNum, 1);
+        size_t done = 0;
+        for (auto& slice : slicePtr) done += slice->maintain(sliceBudget);
+        return done;
+    }
+    void setLowWatermark(double ratio){
+        for (auto& slice : slicePtr) slice->setLowWatermark(ratio);
+    }
+    // 总权重平均分给各个分片
+    void setWeigher(size_t maxWeight, typename Slice::Weigher weigher){
+        size_t sliceWeight = std::ceil(maxWeight / static_cast<double>(sliceNum));
+        for (auto& slice : slicePtr) slice->setWeigher(sliceWeight, weigher);
+    }
+    size_t weight(){
+        size_t total = 0;
+        for (auto& slice : slicePtr) total += slice->weight();
+        return total;
+    }
     size_t Hash(Key key){
         std::hash<Key> myHash;
         return myHash(key);
@@ -37,5 +71,5 @@ public:
 private:
     size_t totalCapacity;
     int sliceNum;
-    std::vector<std::unique_ptr<LruCache<Key, Value>>> slicePtr;
+    std::vector<std::unique_ptr<Slice>> slicePtr;
 };
\ No newline at end of file
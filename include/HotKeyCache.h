@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "caChePolicy.h"
+
+// Space-Saving 热点统计: 最多跟踪 capacity 个键, 新键顶替计数最小的键并继承其计数,
+// 任何出现频率超过 1 / capacity 的键一定在表中, 计数误差不超过被顶替时继承的部分(error).
+// 调用方负责加锁; capacity 很小(几十), 找最小值直接扫描.
+template<typename Key>
+class SpaceSaving{
+public:
+    struct Counter{
+        Key key;
+        uint64_t count;
+        uint64_t error;
+    };
+
+    explicit SpaceSaving(size_t capacity) : _capacity(capacity > 0 ? capacity : 1) {}
+
+    // 返回该键的计数器; count - error 为保证出现过的次数
+    const Counter& offer(const Key& key) {
+        ++_total;
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            ++_counters[it->second].count;
+            return _counters[it->second];
+        }
+        if (_counters.size() < _capacity) {
+            _index[key] = _counters.size();
+            _counters.push_back(Counter{key, 1, 0});
+            return _counters.back();
+        }
+        size_t victim = 0;
+        for (size_t i = 1; i < _counters.size(); ++i) {
+            if (_counters[i].count < _counters[victim].count) victim = i;
+        }
+        Counter& counter = _counters[victim];
+        _index.erase(counter.key);
+        _index[key] = victim;
+        counter.key = key;
+        counter.error = counter.count;
+        ++counter.count;
+        return counter;
+    }
+
+    // 所有计数减半, 让统计跟上热点的变化
+    void decay() {
+        _total /= 2;
+        for (Counter& counter : _counters) {
+            counter.count /= 2;
+            counter.error /= 2;
+        }
+    }
+
+    uint64_t total() const {return _total;}
+    const std::vector<Counter>& counters() const {return _counters;}
+
+private:
+    size_t _capacity;
+    uint64_t _total = 0;
+    std::vector<Counter> _counters;
+    std::unordered_map<Key, size_t> _index;
+};
+
+// 按键哈希分条的版本号表, 用于让各线程私有的副本失效: 写入后增加对应条的版本号,
+// 副本记录读取后端之前看到的版本号, 使用前比较. 不同的键可能共用一条, 只会造成多余的失效.
+class VersionTable{
+public:
+    explicit VersionTable(size_t stripes = 4096)
+    : _mask(roundUp(stripes) - 1)
+    , _versions(new Stripe[_mask + 1])
+    {}
+
+    uint64_t load(size_t hash) const {return _versions[hash & _mask].version.load(std::memory_order_acquire);}
+    void bump(size_t hash) {_versions[hash & _mask].version.fetch_add(1, std::memory_order_acq_rel);}
+
+private:
+    // 每条独占一个缓存行, 热键的写入不影响相邻的条
+    struct alignas(64) Stripe{
+        std::atomic<uint64_t> version{0};
+    };
+
+    static size_t roundUp(size_t n) {
+        size_t size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    size_t _mask;
+    std::unique_ptr<Stripe[]> _versions;
+};
+
+// 每个实例在每个线程上各一份的数据(如 HotKeyCache 的前置缓存).
+// 实例持有所有线程的数据, 便于汇总统计, 实例销毁时一起释放; 线程只按实例编号保存 weak_ptr,
+// 已销毁实例的登记在该线程登记新实例时清理, 不随创建过的实例数增长. 编号不复用.
+template<typename T>
+class PerThread{
+public:
+    PerThread() : _id(nextId()) {}
+
+    PerThread(const PerThread&) = delete;
+    PerThread& operator=(const PerThread&) = delete;
+
+    // 本线程的数据, 第一次调用时以 args 构造
+    template<typename... Args>
+    T& local(const Args&... args) {
+        Registry& registry = threadRegistry();
+        if (registry.lastId == _id) return *registry.last;
+        std::weak_ptr<T>& entry = registry.entries[_id];
+        std::shared_ptr<T> data = entry.lock();
+        if (!data) {
+            data.reset(new T(args...));
+            entry = data;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _all.push_back(data);
+            }
+            prune(registry);
+        }
+        registry.lastId = _id;
+        registry.last = data.get();
+        return *data;
+    }
+
+    // 依次访问所有线程的数据
+    template<typename Visit>
+    void forEach(Visit visit) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& data : _all) visit(*data);
+    }
+
+private:
+    struct Registry{
+        uint64_t lastId = 0;
+        T* last = nullptr;
+        std::unordered_map<uint64_t, std::weak_ptr<T>> entries;
+        size_t pruneAt = 16;
+    };
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> id{0};
+        return ++id;
+    }
+
+    // 不放在 local 中: 那样每组构造参数类型各有一份
+    static Registry& threadRegistry() {
+        thread_local Registry registry;
+        return registry;
+    }
+
+    // 登记数翻倍时才扫描一次, 均摊到每次登记是常数
+    static void prune(Registry& registry) {
+        if (registry.entries.size() < registry.pruneAt) return;
+        for (auto it = registry.entries.begin(); it != registry.entries.end();) {
+            if (it->second.expired()) it = registry.entries.erase(it);
+            else ++it;
+        }
+        registry.pruneAt = std::max<size_t>(16, registry.entries.size() * 2);
+    }
+
+    uint64_t _id;
+    mutable std::mutex _mutex;
+    std::vector<std::shared_ptr<T>> _all;
+};
+
+struct HotKeyOptions{
+    size_t trackedKeys = 64;      // Space-Saving 跟踪的键数
+    unsigned sampleRate = 16;     // 平均每 sampleRate 次读取随机采样一次
+    double hotFraction = 0.01;    // 计数占采样总数的比例达到该值即为热键
+    uint64_t minCount = 16;       // 同时计数至少为该值, 避免刚开始时把偶然出现的键当作热键
+    uint64_t decayInterval = 4096; // 每采样这么多次所有计数减半
+    size_t frontSize = 64;        // 每个线程前置缓存的槽位数(直接映射)
+};
+
+// 热键前置缓存: 挂在 HashLruCache 这类分片缓存之上
+// 读取路径上按线程采样, 用 Space-Saving 找出热键, 热键的哈希发布到一个小的原子数组中.
+// 热键读取后在每个线程私有的前置缓存中保留一份副本, 之后同一线程读取它时只比较版本号, 不进入分片锁;
+// put 写入后端后增加版本号, 各线程的副本在下一次读取时失效.
+// 副本只在它所在的线程上使用, 不需要同步; 统计信息由拥有它的线程写入原子计数器.
+template<typename Key, typename Value>
+class HotKeyCache : public caChepolicy<Key, Value>{
+public:
+    HotKeyCache(caChepolicy<Key, Value>& cache, const HotKeyOptions& options = HotKeyOptions())
+    : _cache(cache)
+    , _options(options)
+    , _detector(options.trackedKeys)
+    , _hot(new std::atomic<size_t>[kHotSlots])
+    {
+        for (size_t i = 0; i < kHotSlots; ++i) _hot[i].store(0, std::memory_order_relaxed);
+    }
+    ~HotKeyCache() override = default;
+
+    void put(Key key, const Value& value) override {
+        _cache.put(key, value);
+        _versions.bump(std::hash<Key>{}(key));
+    }
+
+    bool get(Key key, Value& value) override {
+        size_t hash = std::hash<Key>{}(key);
+        Front& front = _fronts.local(_options.frontSize);
+        if (front.nextRandom() % _options.sampleRate == 0) sample(key, hash);
+        if (!isHot(hash)) return _cache.get(key, value);
+
+        Slot& slot = front.slots[hash % front.slots.size()];
+        uint64_t version = _versions.load(hash);
+        if (slot.valid && slot.version == version && slot.key == key) {
+            front.hits.store(front.hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            value = slot.value;
+            return true;
+        }
+        // 版本号在读取后端之前取得, 读取期间的写入会让这份副本在下次使用时失效
+        if (!_cache.get(key, value)) return false;
+        slot.valid = true;
+        slot.key = key;
+        slot.value = value;
+        slot.version = version;
+        return true;
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 当前发布的热键数
+    size_t hotKeys() const {
+        size_t count = 0;
+        for (size_t i = 0; i < kHotSlots; ++i) count += _hot[i].load(std::memory_order_relaxed) != 0;
+        return count;
+    }
+
+    // 所有线程从前置缓存直接返回的次数
+    uint64_t frontHits() const {
+        uint64_t total = 0;
+        _fronts.forEach([&](const Front& front) {total += front.hits.load(std::memory_order_relaxed);});
+        return total;
+    }
+
+private:
+    static constexpr size_t kHotSlots = 64;
+
+    struct Slot{
+        bool valid = false;
+        Key key{};
+        Value value{};
+        uint64_t version = 0;
+    };
+
+    struct alignas(64) Front{
+        explicit Front(size_t size) : slots(size > 0 ? size : 1), seed(reinterpret_cast<uintptr_t>(this) | 1) {}
+        // xorshift; 随机采样避免固定间隔与访问模式同步, 总是采到同一类键
+        uint64_t nextRandom() {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            return seed;
+        }
+        std::vector<Slot> slots;
+        uint64_t seed;
+        std::atomic<uint64_t> hits{0};
+    };
+
+    // 热键表以哈希直接映射, 0 表示空; 冲突时后发布的键覆盖之前的键
+    static size_t tagOf(size_t hash) {return hash != 0 ? hash : 1;}
+    bool isHot(size_t hash) const {return _hot[hash % kHotSlots].load(std::memory_order_relaxed) == tagOf(hash);}
+
+    // 用保证计数判断, 顶替时继承来的计数不算
+    bool hot(const typename SpaceSaving<Key>::Counter& counter, uint64_t minCount) const {
+        uint64_t count = counter.count - counter.error;
+        return count >= minCount && count >= _detector.total() * _options.hotFraction;
+    }
+
+    // 采样只在拿到锁时进行, 不让统计本身成为新的争用点
+    void sample(const Key& key, size_t hash) {
+        std::unique_lock<std::mutex> lock(_detectorMutex, std::try_to_lock);
+        if (!lock.owns_lock()) return;
+        const auto& counter = _detector.offer(key);
+        if (hot(counter, _options.minCount)) {
+            _hot[hash % kHotSlots].store(tagOf(hash), std::memory_order_relaxed);
+        }
+        if (_detector.total() >= _options.decayInterval) republish();
+    }
+
+    // 计数减半后重新发布: 已经不热的键从热键表中移除
+    void republish() {
+        _detector.decay();
+        for (size_t i = 0; i < kHotSlots; ++i) _hot[i].store(0, std::memory_order_relaxed);
+        for (const auto& counter : _detector.counters()) {
+            if (hot(counter, _options.minCount / 2)) {
+                size_t hash = std::hash<Key>{}(counter.key);
+                _hot[hash % kHotSlots].store(tagOf(hash), std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    caChepolicy<Key, Value>& _cache;
+    HotKeyOptions _options;
+    VersionTable _versions;
+    std::mutex _detectorMutex;
+    SpaceSaving<Key> _detector;
+    std::unique_ptr<std::atomic<size_t>[]> _hot;
+    PerThread<Front> _fronts;
+};
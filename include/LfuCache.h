@@ -1,90 +1,86 @@
 #pragma once
 
 #include <caChePolicy.h>
+#include <CacheLocking.h>
+#include <NodeStorage.h>
+#include <RemovalListener.h>
 
+#include <climits>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 
-template<typename Key, typename Value> class LfuCache;
+// Mutex 为 NullMutex 时得到不加锁的版本, 用于每核独占的缓存
+// Alloc 为所有内部容器的分配器(重新绑定后使用), 例如 CountingAllocator 用于统计内存开销
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>> class LfuCache;
 
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Alloc = std::allocator<char>>
 class FreqList{
 private:
-    struct Node{
-        int freq;
-        Key _key;
-        Value _value;
-        std::weak_ptr<Node> _pre;
-        std::shared_ptr<Node> _next;
-        Node()
-        :freq(1), _next(nullptr){}
-        Node(Key key, Value value)
-        :freq(1), _key(key), _value(value), _next(nullptr) {}
-    };
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
     int _freq;
-    using NodePtr = std::shared_ptr<Node>;
-    NodePtr _head;
-    NodePtr _tail;
+    Storage* _storage; // 节点存放在所属 LfuCache 的存储中
+    typename Storage::List _list;
 
 public:
-    explicit FreqList(int n)
+    FreqList(int n, Storage& storage)
     : _freq(n)
-    {
-        _head = std::make_shared<Node>();
-        _tail = std::make_shared<Node> ();
-        _head->_next = _tail;
-        _tail->_pre = _head;
-    }
+    , _storage(&storage)
+    {}
     bool isEmpty(){
-        return _head->_next == _tail;
+        return _list.empty();
     }
-    void addNode(NodePtr node){
-        if (!node || !_head || !_tail)
-            return;
-        node->_pre = _tail->_pre;
-        node->_next = _tail;
-        _tail->_pre.lock()->_next = node;
-        _tail->_pre = node;
+    void addNode(NodeIndex node){
+        _storage->pushBack(_list, node);
     }
-    void removeNode(NodePtr node){
-        if (!node || !_head || !_tail) return;
-        if (node->_pre.expired() || !node->_next) return;
-        node->_pre.lock()->_next = node->_next;
-        node->_next->_pre = node->_pre;
-        node->_next = nullptr;
+    void removeNode(NodeIndex node){
+        _storage->unlink(_list, node);
     }
-    NodePtr getFirstNode() const {return _head->_next;}
-    friend class LfuCache<Key, Value>;
+    NodeIndex getFirstNode() const {return _list.head;}
+    template<typename K, typename V, typename M, typename A> friend class LfuCache;
 };
 
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Mutex, typename Alloc>
 class LfuCache : public caChepolicy<Key, Value>{
 public:
-    using Node = typename FreqList<Key, Value>::Node;
-    using NodePtr = std::shared_ptr<Node>;
-    using NodeMap = std::unordered_map<Key, NodePtr>;
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex, std::hash<Key>, std::equal_to<Key>,
+                                       RebindAlloc<Alloc, std::pair<const Key, NodeIndex>>>;
+    using FreqListPtr = std::shared_ptr<FreqList<Key, Value, Alloc>>;
+    using FreqMap = std::unordered_map<int, FreqListPtr, std::hash<int>, std::equal_to<int>,
+                                       RebindAlloc<Alloc, std::pair<const int, FreqListPtr>>>;
 
-    LfuCache(int n, int maxAverageNum = 10)
+    LfuCache(int n, int maxAverageNum = 10, const Alloc& alloc = Alloc())
     :_capacity(n),_maxAverageNum(maxAverageNum),_minFreq(INT8_MAX)
-    ,_curTotalNum(0),_curAverageNum(0)
+    ,_curTotalNum(0),_curAverageNum(0),_maxFreq(maxAverageNum > INT_MAX / 2 ? INT_MAX : maxAverageNum * 2)
+    ,_alloc(alloc),_storage(n > 0 ? n : 0, alloc)
+    ,_nodeMap(alloc),_freqToFreqList(alloc),_agingFreqs(alloc)
     {}
     ~LfuCache() override = default;
     void put(Key _key,const Value& _value) override {
         if (_capacity == 0) return;
-        std::lock_guard<std::mutex> lock(_mutex);
-        auto it = _nodeMap.find(_key);
-        if (it != _nodeMap.end()){
-            it->second->_value = _value;
-            Value dummyVal = _value;
-            getInternal(it->second, dummyVal);
-            return;
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            auto it = _nodeMap.find(_key);
+            if (it != _nodeMap.end()){
+                if (_notifier.enabled())
+                    _notifier.record(_key, _storage.value(it->second), RemovalCause::Replaced);
+                _storage.value(it->second) = _value;
+                Value dummyVal = _value;
+                getInternal(it->second, dummyVal);
+            } else {
+                putInternal(_key, _value);
+            }
         }
-        putInternal(_key, _value);
+        _notifier.dispatch();
     }
     bool get(Key _key, Value& _value) override {
-        std::lock_guard<std::mutex> lock(_mutex);
+        std::lock_guard<Mutex> lock(_mutex);
         auto it = _nodeMap.find(_key);
         if (it != _nodeMap.end()){
             getInternal(it->second, _value);
@@ -97,29 +93,63 @@ public:
         this->get(_key, _value);
         return _value;
     }
+
+    // 后台维护: 先主动淘汰到低水位, 再分片推进延后的老化, 返回完成的工作量
+    size_t maintain(size_t budget);
+    // 默认每次 get/put 顺带老化最多 kAgingStep 个节点; 开启后 get/put 只做标记, 老化全部交给 maintain().
+    // 需要有空闲的 CPU 运行维护线程, 见 MaintenanceExecutor.h
+    void setBackgroundAging(bool enable) {
+        std::lock_guard<Mutex> lock(_mutex);
+        _backgroundAging = enable;
+    }
+    // 低水位(容量的比例), maintain() 会把缓存淘汰到该水位以下, 默认 1.0 即不主动淘汰
+    void setLowWatermark(double ratio) {
+        std::lock_guard<Mutex> lock(_mutex);
+        _lowWatermark = ratio;
+    }
+    // 移除监听器: 通知在锁内缓冲, 攒够 batchSize 条后在锁外批量投递
+    void setRemovalListener(typename RemovalNotifier<Key, Value>::Listener listener, size_t batchSize = 64) {
+        _notifier.setListener(std::move(listener), batchSize);
+    }
+    void flushRemovals() {_notifier.flush();}
 private:
     void putInternal(Key key,const Value& value); // 添加缓存
-    void getInternal(NodePtr node,Value& value); // 获取缓存(update)
+    void getInternal(NodeIndex node,Value& value); // 获取缓存(update)
 
     void kickOut(); // 移除缓存中的过期数据
 
-    void removeFromFreqList(NodePtr node); // 从频率列表中移除节点
-    void addToFreqList(NodePtr node); // 添加到频率列表
+    void removeFromFreqList(NodeIndex node); // 从频率列表中移除节点
+    void addToFreqList(NodeIndex node); // 添加到频率列表
 
-    void addFreqNum(); // 增加平均访问等频率
+    // 频次保存在节点的热数据记录中
+    int freqOf(NodeIndex node) {return static_cast<int>(_storage.link(node).count);}
+    void setFreq(NodeIndex node, int freq) {_storage.link(node).count = static_cast<uint32_t>(freq);}
+
+    void addFreqNum(int num); // 增加平均访问等频率
     void decreaseFreqNum(int num); // 减少平均访问等频率
-    void handleOverMaxAverageNum(); // 处理当前平均访问频率超过上限的情况
     void updateMinFreq();
+    void startAging(); // 记录需要老化的频次桶
+    size_t ageSlice(size_t budget); // 老化最多 budget 个节点
 
 private:
+    static constexpr size_t kAgingStep = 8; // 请求线程每次操作最多老化的节点数
+
     int  _capacity; // 缓存容量
     int  _minFreq; // 最小访问频次(用于找到最小访问频次结点)
     int  _maxAverageNum; // 最大平均访问频次
-    int  _curAverageNum; // 当前平均访问频次
-    int  _curTotalNum; // 当前访问所有缓存次数总数 
-    std::mutex  _mutex; // 互斥锁
+    long long  _curAverageNum; // 当前平均访问频次
+    long long  _curTotalNum; // 当前访问所有缓存次数总数 
+    int  _maxFreq; // 频次上限(最大平均访问频次的两倍)
+    Mutex  _mutex; // 互斥锁
+    Alloc  _alloc; // 频次链表(shared_ptr)也从这里分配
+    Storage  _storage; // 节点存储(热数据与键值分离)
     NodeMap  _nodeMap; // key 到 缓存节点的映射
-    std::unordered_map<int, std::shared_ptr<FreqList<Key, Value>>> _freqToFreqList;;// 访问频次到该频次链表的映射
+    FreqMap _freqToFreqList;// 访问频次到该频次链表的映射
+    bool _backgroundAging = false; // 老化是否交给 maintain()
+    bool _agingPending = false; // 是否有尚未完成的分片老化
+    std::vector<int, RebindAlloc<Alloc, int>> _agingFreqs; // 待老化的频次桶
+    double _lowWatermark = 1.0; // 主动淘汰的低水位比例
+    RemovalNotifier<Key, Value> _notifier; // 移除通知
 };
 
 #include "../src/LfuCache.tpp"
\ No newline at end of file
@@ -1,64 +1,50 @@
 #pragma once
 
-#include <list>
 #include <unordered_map>
 #include <mutex>
-#include <memory>
+#include <functional>
 
 #include "caChePolicy.h"
+#include "CacheLocking.h"
+#include "NodeStorage.h"
+#include "RemovalListener.h"
 
-template<typename Key, typename Value> class LruCache;
+// Mutex 为 NullMutex 时得到不加锁的版本, 用于每核独占的缓存
+// Alloc 为所有内部容器的分配器(重新绑定后使用), 例如 CountingAllocator 用于统计内存开销
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>> class LruCache;
 
-template<typename Key, typename Value> 
-class LruNode{
-public:
-    LruNode(Key key, Value value):
-        _key(key),
-        _val(value),
-        accessCount(1)
-    {}
-    friend class LruCache<Key, Value>;
-
-    Key getKey() const {return _key;}
-    Value getValue() const {return _val;}
-    void setValue(const Value& val) {_val = val;}
-    size_t getAccessCount() const {return accessCount;}
-    void incrementAccessCount() {++accessCount;}
-
-private:
-    Key _key;
-    Value _val;
-    size_t accessCount;
-    std::weak_ptr<LruNode<Key, Value>> prev;
-    std::shared_ptr<LruNode<Key, Value>> next;
-};
-
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Mutex, typename Alloc>
 class LruCache : public caChepolicy<Key, Value>{
 public:
-    using LruNodeType = LruNode<Key, Value>;
-    using NodePtr = std::shared_ptr<LruNodeType>;
-    using NodeMap = std::unordered_map<Key, NodePtr>;
-    LruCache(int capacity_):capacity(capacity_){
-        init();
-    }
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex, std::hash<Key>, std::equal_to<Key>,
+                                       RebindAlloc<Alloc, std::pair<const Key, NodeIndex>>>;
+    LruCache(int capacity_, const Alloc& alloc = Alloc())
+        : capacity(capacity_)
+        , nodeMap_(alloc)
+        , storage_(capacity_ > 0 ? capacity_ : 0, alloc)
+    {}
     ~LruCache() override = default;
     void put(Key key, const Value& value) override{
         if (capacity <= 0) return;
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = nodeMap_.find(key);
-        if (it != nodeMap_.end()){
-            updateExistingNode(it->second, value);
-            return;
+        {
+            std::lock_guard<Mutex> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end()){
+                updateExistingNode(it->second, value);
+            } else {
+                addNode(key, value);
+            }
         }
-        addNode(key, value);
+        notifier_.dispatch();
     }
     bool get(Key key, Value& value) override{
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<Mutex> lock(mutex_);
         auto it = nodeMap_.find(key);
         if (it != nodeMap_.end()){
             updateLocating(it->second);
-            value = it->second->getValue();
+            value = storage_.value(it->second);
             return true;
         }
         return false;
@@ -69,58 +55,123 @@ public:
         return value;
     }
     void remove(Key key){
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = nodeMap_.find(key);
-        if (it != nodeMap_.end()){
-            removeNode(it->second);
-            nodeMap_.erase(key);
+        {
+            std::lock_guard<Mutex> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end()){
+                if (notifier_.enabled())
+                    notifier_.record(key, storage_.value(it->second), RemovalCause::Explicit);
+                if (weigher_) weight_ -= weigher_(key, storage_.value(it->second));
+                removeNode(it->second);
+                storage_.release(it->second);
+                nodeMap_.erase(it);
+            }
         }
+        notifier_.dispatch();
+    }
+    // 移除监听器: 通知在锁内缓冲, 攒够 batchSize 条后在锁外批量投递
+    void setRemovalListener(typename RemovalNotifier<Key, Value>::Listener listener, size_t batchSize = 64){
+        notifier_.setListener(std::move(listener), batchSize);
+    }
+    // 立即投递缓冲中剩余的通知
+    void flushRemovals(){
+        notifier_.flush();
+    }
+    // 后台维护: 主动淘汰到低水位, 每次最多淘汰 budget 个, 返回淘汰数量
+    size_t maintain(size_t budget){
+        size_t done = 0;
+        {
+            std::lock_guard<Mutex> lock(mutex_);
+            size_t lowWatermark = static_cast<size_t>(capacity * lowWatermark_);
+            while (done < budget && !nodeMap_.empty() && nodeMap_.size() > lowWatermark){
+                evictLeastRecent();
+                ++done;
+            }
+        }
+        notifier_.dispatch();
+        return done;
+    }
+    // 低水位(容量的比例), 默认 1.0 即不主动淘汰
+    void setLowWatermark(double ratio){
+        std::lock_guard<Mutex> lock(mutex_);
+        lowWatermark_ = ratio;
+    }
+    // 按权重限制容量: 所有条目的 weigher(key, value) 之和不超过 maxWeight, 条目数上限仍然有效.
+    // weigher 对同一个值必须返回相同的结果(淘汰时重新计算, 不保存在节点中)
+    using Weigher = std::function<size_t(const Key&, const Value&)>;
+    void setWeigher(size_t maxWeight, Weigher weigher){
+        {
+            std::lock_guard<Mutex> lock(mutex_);
+            maxWeight_ = maxWeight;
+            weigher_ = std::move(weigher);
+            weight_ = 0;
+            for (NodeIndex node = lruList_.head; node != Storage::npos; node = storage_.link(node).next)
+                weight_ += weigher_(storage_.key(node), storage_.value(node));
+            trimToWeight(Storage::npos);
+        }
+        notifier_.dispatch();
+    }
+    size_t weight(){
+        std::lock_guard<Mutex> lock(mutex_);
+        return weight_;
     }
 private:
-    void init(){
-        dummyHead = std::make_shared<LruNode<Key, Value>>(Key(), Value());
-        dummyTail = std::make_shared<LruNode<Key, Value>>(Key(), Value());
-        dummyHead->next = dummyTail;
-        dummyTail->prev = dummyHead;
-    }
-    void updateExistingNode(NodePtr& node, const Value& value){
-        node->setValue(value);
+    void updateExistingNode(NodeIndex node, const Value& value){
+        if (notifier_.enabled())
+            notifier_.record(storage_.key(node), storage_.value(node), RemovalCause::Replaced);
+        if (weigher_){
+            weight_ -= weigher_(storage_.key(node), storage_.value(node));
+            weight_ += weigher_(storage_.key(node), value);
+        }
+        storage_.value(node) = value;
         updateLocating(node);
+        if (weigher_) trimToWeight(node);
     }
     void addNode(const Key& key,const Value& value){
         if (nodeMap_.size() >= capacity) evictLeastRecent();
-        NodePtr node = std::make_shared<LruNode<Key, Value>>(key, value);
+        NodeIndex node = storage_.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
         nodeMap_[key] = node;
         insertNode(node);
+        if (weigher_){
+            weight_ += weigher_(key, value);
+            trimToWeight(node);
+        }
     }
-    void updateLocating(NodePtr node){
-        removeNode(node);
-        insertNode(node);
+    // 从最久未访问端淘汰到总权重不超过上限, keep 为刚写入的节点, 不淘汰它自己
+    void trimToWeight(NodeIndex keep){
+        while (weight_ > maxWeight_ && lruList_.head != Storage::npos && lruList_.head != keep)
+            evictLeastRecent();
     }
-    void removeNode(NodePtr node){
-        if (!node->prev.expired() && node->next){
-            auto prev_ = node->prev.lock();
-            prev_->next = node->next;
-            node->next->prev = prev_;
-            node->next = nullptr;
-        }
+    void updateLocating(NodeIndex node){
+        storage_.moveToBack(lruList_, node);
+    }
+    void removeNode(NodeIndex node){
+        storage_.unlink(lruList_, node);
     }
-    void insertNode(NodePtr node){
-        node->next = dummyTail;
-        node->prev = dummyTail->prev;
-        dummyTail->prev.lock()->next = node;
-        dummyTail->prev = node;
+    // 链表尾部为最近访问
+    void insertNode(NodeIndex node){
+        storage_.pushBack(lruList_, node);
     }
     void evictLeastRecent(){
-        NodePtr leastRecentNode = dummyHead->next;
+        NodeIndex leastRecentNode = lruList_.head;
+        if (leastRecentNode == Storage::npos) return;
+        if (notifier_.enabled())
+            notifier_.record(storage_.key(leastRecentNode), storage_.value(leastRecentNode), RemovalCause::Capacity);
+        if (weigher_) weight_ -= weigher_(storage_.key(leastRecentNode), storage_.value(leastRecentNode));
         removeNode(leastRecentNode);
-        nodeMap_.erase(leastRecentNode->getKey());
+        nodeMap_.erase(storage_.key(leastRecentNode));
+        storage_.release(leastRecentNode);
     }
 private:
     int capacity;
+    double lowWatermark_ = 1.0;
     NodeMap nodeMap_;
-    std::mutex mutex_;
-    NodePtr dummyHead;
-    NodePtr dummyTail;
+    Mutex mutex_;
+    Storage storage_;
+    typename Storage::List lruList_; // 头部为最久未访问
+    RemovalNotifier<Key, Value> notifier_;
+    Weigher weigher_; // 为空时只按条目数限制
+    size_t maxWeight_ = 0;
+    size_t weight_ = 0;
 };
 
@@ -1,13 +1,14 @@
 #pragma once
 #include "LruCache.h"
 
-template<typename Key, typename Value>
-class LruKCache : public LruCache<Key, Value> {
+template<typename Key, typename Value, typename Alloc = std::allocator<char>>
+class LruKCache : public LruCache<Key, Value, std::mutex, Alloc> {
 public:
-    LruKCache(int capacity, int hisCapacity, int k_):
-        LruCache<Key, Value>(capacity),
+    LruKCache(int capacity, int hisCapacity, int k_, const Alloc& alloc = Alloc()):
+        LruCache<Key, Value, std::mutex, Alloc>(capacity, alloc),
         k(k_),
-        historyPtr(std::make_unique<LruCache<Key, size_t>>(hisCapacity))
+        historyPtr(std::make_unique<LruCache<Key, size_t, std::mutex, Alloc>>(hisCapacity, alloc)),
+        historytMap(alloc)
     {}
     Value get(Key key){
         Value value{};
@@ -15,7 +16,7 @@ public:
         return value;
     }
     bool get(Key key, Value& value){
-        bool inMainCaChe = LruCache<Key, Value>::get(key, value);
+        bool inMainCaChe = LruCache<Key, Value, std::mutex, Alloc>::get(key, value);
         if (inMainCaChe) return true;
         size_t historyCount = historyPtr->get(key);
         historyCount++;
@@ -24,7 +25,7 @@ public:
             auto it = historytMap.find(key);
             if (it != historytMap.end()){
                 value = it->second;
-                LruCache<Key, Value>::put(key, value);  // 晋升到主缓存
+                LruCache<Key, Value, std::mutex, Alloc>::put(key, value);  // 晋升到主缓存
                 historyPtr->remove(key);
                 historytMap.erase(it);
                 return true;
@@ -35,9 +36,9 @@ public:
     }
     void put(Key key, const Value& value){
         Value existingValue{};
-        bool inMainCaChe = LruCache<Key, Value>::get(key, existingValue);
+        bool inMainCaChe = LruCache<Key, Value, std::mutex, Alloc>::get(key, existingValue);
         if (inMainCaChe){
-            LruCache<Key, Value>::put(key, value);
+            LruCache<Key, Value, std::mutex, Alloc>::put(key, value);
             return;
         }
         size_t historyCount = historyPtr->get(key);
@@ -45,13 +46,14 @@ public:
         historyPtr->put(key, historyCount);
         historytMap[key] = value;
         if (historyCount >= k){
-            LruCache<Key, Value>::put(key, value);
+            LruCache<Key, Value, std::mutex, Alloc>::put(key, value);
             historyPtr->remove(key);
             historytMap.erase(key);
         }
     }
 private:
     int k;
-    std::unique_ptr<LruCache<Key, size_t>> historyPtr;
-    std::unordered_map<Key, Value> historytMap;
+    std::unique_ptr<LruCache<Key, size_t, std::mutex, Alloc>> historyPtr;
+    std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>,
+                       RebindAlloc<Alloc, std::pair<const Key, Value>>> historytMap;
 };
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// LZ4 块格式的压缩与解压(只实现块格式, 不含帧头与校验)
+// 压缩: 12 位哈希表记录最近出现的 4 字节序列, 贪心匹配, 连续未命中时加大步长跳过难压缩的区域.
+// 输出与 LZ4 块格式兼容, 可以用标准 LZ4 解压.
+namespace lz4{
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;  // 块末尾至少 5 字节为字面量
+constexpr size_t kMatchLimit = 12;   // 最后一个匹配的起点距块末尾至少 12 字节
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashBits = 12;
+
+// 最坏情况(完全不可压缩)下的输出大小
+constexpr size_t compressBound(size_t size) {return size + size / 255 + 16;}
+
+namespace detail{
+
+inline uint32_t read32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash(uint32_t sequence) {return (sequence * 2654435761u) >> (32 - kHashBits);}
+
+// 长度超过 15 的部分按 255 一组追加
+inline char* writeLength(char* op, size_t length) {
+    while (length >= 255) {
+        *op++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *op++ = static_cast<char>(length);
+    return op;
+}
+
+inline char* writeSequence(char* op, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    char* token = op++;
+    uint8_t high = literalLength >= 15 ? 15 : static_cast<uint8_t>(literalLength);
+    if (literalLength >= 15) op = writeLength(op, literalLength - 15);
+    std::memcpy(op, literals, literalLength);
+    op += literalLength;
+    uint8_t low = 0;
+    if (matchLength > 0) {
+        *op++ = static_cast<char>(offset & 0xFF);
+        *op++ = static_cast<char>(offset >> 8);
+        size_t extra = matchLength - kMinMatch;
+        low = extra >= 15 ? 15 : static_cast<uint8_t>(extra);
+        if (extra >= 15) op = writeLength(op, extra - 15);
+    }
+    *token = static_cast<char>((high << 4) | low);
+    return op;
+}
+
+} // namespace detail
+
+// 返回压缩后的字节数, dst 至少要有 compressBound(size) 字节
+inline size_t compress(const char* src, size_t size, char* dst) {
+    using namespace detail;
+    char* op = dst;
+    size_t anchor = 0;
+    if (size > kMatchLimit) {
+        uint32_t table[1 << kHashBits];
+        std::memset(table, 0xFF, sizeof(table));
+        size_t limit = size - kMatchLimit;
+        size_t matchEnd = size - kLastLiterals;
+        size_t ip = 0;
+        unsigned misses = 0;
+        while (ip < limit) {
+            uint32_t sequence = read32(src + ip);
+            uint32_t h = hash(sequence);
+            uint32_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+            if (ref == UINT32_MAX || ip - ref > kMaxOffset || read32(src + ref) != sequence) {
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            size_t length = kMinMatch;
+            while (ip + length < matchEnd && src[ref + length] == src[ip + length]) ++length;
+            op = writeSequence(op, src + anchor, ip - anchor, ip - ref, length);
+            ip += length;
+            anchor = ip;
+        }
+    }
+    op = writeSequence(op, src + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+
+// 解压到 dst, 返回解压后的字节数; 输入损坏或 dst 放不下时返回 SIZE_MAX
+inline size_t decompress(const char* src, size_t size, char* dst, size_t capacity) {
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* end = ip + size;
+    size_t out = 0;
+    auto readLength = [&](size_t length) -> size_t {
+        if (length != 15) return length;
+        uint8_t byte;
+        do {
+            if (ip >= end) return SIZE_MAX;
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return length;
+    };
+    while (ip < end) {
+        uint8_t token = *ip++;
+        size_t literalLength = readLength(token >> 4);
+        if (literalLength == SIZE_MAX || literalLength > static_cast<size_t>(end - ip) || literalLength > capacity - out)
+            return SIZE_MAX;
+        std::memcpy(dst + out, ip, literalLength);
+        ip += literalLength;
+        out += literalLength;
+        if (ip == end) break; // 最后一个序列只有字面量
+        if (end - ip < 2) return SIZE_MAX;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        size_t matchLength = readLength(token & 15);
+        if (matchLength == SIZE_MAX || offset == 0 || offset > out) return SIZE_MAX;
+        matchLength += kMinMatch;
+        if (matchLength > capacity - out) return SIZE_MAX;
+        char* op = dst + out;
+        const char* match = op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+        } else {
+            // 重叠的匹配(如连续重复的字节)只能逐字节复制
+            for (size_t i = 0; i < matchLength; ++i) op[i] = match[i];
+        }
+        out += matchLength;
+    }
+    return out;
+}
+
+} // namespace lz4
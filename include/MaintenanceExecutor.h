@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 后台维护线程
+// 缓存注册一个 maintain(budget) 任务, 执行器循环调用: 每次最多给 budget 个单位的工作量,
+// 返回实际完成的工作量; 一轮中没有任何任务做事时睡眠 interval.
+// 主动淘汰到低水位、频次老化、幽灵链表裁剪都在这里分片完成, 不再占用请求线程
+// 只有维护线程能拿到空闲的 CPU 时才有收益. CPU 被请求线程占满(或只有一个核)时, 维护线程与请求线程
+// 轮流运行, 工作量并没有减少, 请求反而可能等待维护线程的一个分片或整个调度时间片: 在单核的测试机上
+// 场景 7 中后台模式的 p99 / p999 与同步处理相当, max 与 ArcCache 的 p999 有时更差. 这种情况下应保持默认的
+// 同步处理(每次操作只做很少的一部分), 不要启动执行器
+class MaintenanceExecutor{
+public:
+    using Task = std::function<size_t(size_t budget)>;
+
+    explicit MaintenanceExecutor(std::chrono::milliseconds interval = std::chrono::milliseconds(1),
+                                 size_t sliceBudget = 256)
+    : _interval(interval)
+    , _sliceBudget(sliceBudget)
+    {}
+    MaintenanceExecutor(const MaintenanceExecutor&) = delete;
+    MaintenanceExecutor& operator=(const MaintenanceExecutor&) = delete;
+    ~MaintenanceExecutor() {stop();}
+
+    size_t registerTask(Task task) {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _tasks.emplace_back(++_nextId, std::move(task));
+        return _nextId;
+    }
+
+    // 任何暴露 size_t maintain(size_t) 的缓存都可以注册; 注销前缓存必须保持存活
+    template<typename CacheType>
+    size_t registerCache(CacheType& cache) {
+        return registerTask([&cache](size_t budget) {return cache.maintain(budget);});
+    }
+
+    // 返回后保证该任务不会再被执行
+    void unregisterTask(size_t id) {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        for (auto it = _tasks.begin(); it != _tasks.end(); ++it){
+            if (it->first == id){
+                _tasks.erase(it);
+                return;
+            }
+        }
+    }
+
+    // 同步执行一轮, 返回本轮完成的工作量
+    size_t runOnce() {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        size_t work = 0;
+        for (auto& task : _tasks) work += task.second(_sliceBudget);
+        return work;
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(_stateMutex);
+        if (_thread.joinable()) return;
+        _stopping = false;
+        _thread = std::thread([this] {loop();});
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(_stateMutex);
+            if (!_thread.joinable()) return;
+            _stopping = true;
+        }
+        _wakeup.notify_all();
+        _thread.join();
+    }
+
+private:
+    void loop() {
+        while (true){
+            size_t work = runOnce();
+            std::unique_lock<std::mutex> lock(_stateMutex);
+            if (_stopping) return;
+            if (work > 0){
+                // 还有积压, 让出 CPU 后立即继续
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+            _wakeup.wait_for(lock, _interval, [this] {return _stopping;});
+            if (_stopping) return;
+        }
+    }
+
+private:
+    std::chrono::milliseconds _interval;
+    size_t _sliceBudget;
+
+    std::mutex _taskMutex;
+    std::vector<std::pair<size_t, Task>> _tasks;
+    size_t _nextId = 0;
+
+    std::mutex _stateMutex;
+    std::condition_variable _wakeup;
+    bool _stopping = false;
+    std::thread _thread;
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#ifdef __linux__
+#include <time.h>
+#endif
+
+#include "caChePolicy.h"
+
+// 带过期时间的计数布隆过滤器, 记录"最近确认不存在"的键哈希
+// 按时间分成 kGenerations 代, 每代覆盖 ttl / (kGenerations - 1) 的时间; 写入只进当前代,
+// 当前代到期后轮换, 最老的一代被清空复用. 条目在写入后 ttl 到 ttl * kGenerations / (kGenerations - 1)
+// 之间失效. 查询无锁, 只读 k 个 8 位计数器; 轮换在写入路径上加锁进行.
+// 计数器支持删除(键后来被写入时调用 erase, 删除到查询不再命中为止). 误判方向: 布隆过滤器的假阳性会把一个没有记录过的键
+// 当作"不存在", 概率由 falsePositiveRate 控制; 并发轮换或饱和计数只会让键提前失效, 偏向安全的一侧.
+class NegativeFilter{
+public:
+    static constexpr int kGenerations = 3;
+
+    // expectedKeys 为一个 ttl 内预计记录的键数
+    NegativeFilter(size_t expectedKeys, std::chrono::milliseconds ttl, double falsePositiveRate = 0.001)
+    : _period(std::max<int64_t>(ttl.count() / (kGenerations - 1), 1))
+    {
+        double n = static_cast<double>(expectedKeys > 0 ? expectedKeys : 1);
+        double ln2 = std::log(2.0);
+        size_t need = static_cast<size_t>(std::ceil(-n * std::log(falsePositiveRate) / (ln2 * ln2)));
+        _hashes = std::max(1, static_cast<int>(std::lround(need / n * ln2)));
+        // 向上取到 2 的幂, 用掩码取位置
+        _cells = 64;
+        while (_cells < need) _cells <<= 1;
+        int64_t now = nowMs();
+        for (Generation& gen : _generations) {
+            gen.counters.reset(new std::atomic<uint8_t>[_cells]);
+            for (size_t i = 0; i < _cells; ++i) gen.counters[i].store(0, std::memory_order_relaxed);
+            gen.start.store(now - _period * kGenerations, std::memory_order_relaxed); // 初始即已过期
+        }
+        _generations[0].start.store(now, std::memory_order_relaxed);
+    }
+
+    // 未过期的代中是否记录过该哈希
+    bool contains(uint64_t hash) const {
+        int64_t now = nowMs();
+        for (const Generation& gen : _generations) {
+            if (alive(gen, now) && containsIn(gen, hash)) return true;
+        }
+        return false;
+    }
+
+    // 当前代已经包含该哈希时不再增加, 同一个键被记录多次(并发未命中)也只占一份计数
+    void insert(uint64_t hash) {
+        Generation& gen = current(nowMs());
+        if (containsIn(gen, hash)) return;
+        forEachCell(hash, [&](size_t cell) {
+            std::atomic<uint8_t>& counter = gen.counters[cell];
+            uint8_t cur = counter.load(std::memory_order_relaxed);
+            while (cur < UINT8_MAX && !counter.compare_exchange_weak(cur, cur + 1, std::memory_order_relaxed)) {}
+        });
+    }
+
+    // 从记录过它的各代中删除, 直到查询不再命中: 并发的 insert 仍可能把同一个键记录两次.
+    // 饱和的计数器不会减少, 若一轮下来没有进展, 把其中一个饱和计数器清零 --
+    // 这只会让共用它的其他键提前失效, 偏向安全的一侧
+    void erase(uint64_t hash) {
+        int64_t now = nowMs();
+        for (Generation& gen : _generations) {
+            while (alive(gen, now) && containsIn(gen, hash)) {
+                bool progress = false;
+                std::atomic<uint8_t>* saturated = nullptr;
+                forEachCell(hash, [&](size_t cell) {
+                    std::atomic<uint8_t>& counter = gen.counters[cell];
+                    uint8_t cur = counter.load(std::memory_order_relaxed);
+                    if (cur == UINT8_MAX) saturated = &counter;
+                    while (cur > 0 && cur < UINT8_MAX && !counter.compare_exchange_weak(cur, cur - 1, std::memory_order_relaxed)) {}
+                    if (cur > 0 && cur < UINT8_MAX) progress = true;
+                });
+                if (!progress && saturated) saturated->store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t bytes() const {return _cells * kGenerations;}
+    int hashes() const {return _hashes;}
+
+private:
+    struct Generation{
+        std::unique_ptr<std::atomic<uint8_t>[]> counters;
+        std::atomic<int64_t> start{0}; // 毫秒
+    };
+
+    // 单调时钟, Linux 上使用粗粒度时钟(几纳秒, 精度为一个时钟节拍)
+    static int64_t nowMs() {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#else
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // 一代在开始后 kGenerations 个周期内有效: 最后写入的条目也已存在满 ttl
+    bool alive(const Generation& gen, int64_t now) const {
+        return now - gen.start.load(std::memory_order_relaxed) < _period * kGenerations;
+    }
+
+    Generation& current(int64_t now) {
+        int index = _current.load(std::memory_order_acquire);
+        if (now - _generations[index].start.load(std::memory_order_relaxed) < _period) return _generations[index];
+        std::lock_guard<std::mutex> lock(_rotateMutex);
+        index = _current.load(std::memory_order_relaxed);
+        if (now - _generations[index].start.load(std::memory_order_relaxed) >= _period) {
+            index = (index + 1) % kGenerations;
+            Generation& next = _generations[index];
+            // 先标记为过期, 清空期间的查询直接跳过这一代
+            next.start.store(now - _period * kGenerations, std::memory_order_relaxed);
+            for (size_t i = 0; i < _cells; ++i) next.counters[i].store(0, std::memory_order_relaxed);
+            next.start.store(now, std::memory_order_release);
+            _current.store(index, std::memory_order_release);
+        }
+        return _generations[index];
+    }
+
+    // 遇到为 0 的计数器即返回, 未记录的键通常只读一两个计数器
+    bool containsIn(const Generation& gen, uint64_t hash) const {
+        uint64_t h1, h2;
+        split(hash, h1, h2);
+        for (int i = 0; i < _hashes; ++i) {
+            if (gen.counters[(h1 + i * h2) & (_cells - 1)].load(std::memory_order_relaxed) == 0) return false;
+        }
+        return true;
+    }
+
+    // 双重哈希: 第 i 个位置为 h1 + i * h2
+    static void split(uint64_t hash, uint64_t& h1, uint64_t& h2) {
+        uint64_t h = hash * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 32;
+        h1 = h;
+        h2 = ((h * 0xBF58476D1CE4E5B9ULL) >> 17) | 1;
+    }
+
+    template<typename Fn>
+    void forEachCell(uint64_t hash, Fn fn) const {
+        uint64_t h1, h2;
+        split(hash, h1, h2);
+        for (int i = 0; i < _hashes; ++i) fn((h1 + i * h2) & (_cells - 1));
+    }
+
+private:
+    int64_t _period;
+    size_t _cells = 0;
+    int _hashes = 1;
+    Generation _generations[kGenerations];
+    std::atomic<int> _current{0};
+    std::mutex _rotateMutex;
+};
+
+// 给任意 caChepolicy 附加不存在键的记录
+// 后端确认不存在的键通过 markAbsent 记入过滤器, 之后 knownAbsent 无锁地直接回答, 不进入缓存的分片锁,
+// 也不为这些键占用缓存条目. put 会把键从过滤器中删除.
+template<typename Key, typename Value>
+class NegativeCache : public caChepolicy<Key, Value>{
+public:
+    NegativeCache(caChepolicy<Key, Value>& cache, size_t expectedKeys, std::chrono::milliseconds ttl,
+                  double falsePositiveRate = 0.001)
+    : _cache(cache)
+    , _filter(expectedKeys, ttl, falsePositiveRate)
+    {}
+    ~NegativeCache() override = default;
+
+    void put(Key key, const Value& value) override {
+        _filter.erase(std::hash<Key>{}(key));
+        _cache.put(key, value);
+    }
+
+    bool get(Key key, Value& value) override {return _cache.get(key, value);}
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    bool knownAbsent(const Key& key) const {return _filter.contains(std::hash<Key>{}(key));}
+    void markAbsent(const Key& key) {_filter.insert(std::hash<Key>{}(key));}
+
+    // 先查过滤器, 再查缓存, 都未命中时调用 loader(key, value) 访问后端;
+    // loader 返回 true 时写入缓存, 返回 false 时记为不存在
+    template<typename Loader>
+    bool getOrLoad(const Key& key, Value& value, Loader&& loader) {
+        if (knownAbsent(key)) return false;
+        if (_cache.get(key, value)) return true;
+        if (loader(key, value)) {
+            put(key, value);
+            return true;
+        }
+        markAbsent(key);
+        return false;
+    }
+
+    const NegativeFilter& filter() const {return _filter;}
+
+private:
+    caChepolicy<Key, Value>& _cache;
+    NegativeFilter _filter;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "CacheAllocator.h"
+
+// 冷热分离的节点存储
+// 热数据: 链表指针、键哈希指纹、访问计数, 紧凑的 16 字节记录, 连续存放在 _links 中
+// 冷数据: key 与 value 分别放在独立的数组里, 只有真正读写键值时才会被载入缓存行
+// 节点用 32 位下标代替 shared_ptr / weak_ptr, 没有控制块, 也没有引用计数的原子操作;
+// 淘汰时沿链表遍历只会访问 _links
+template<typename Key, typename Value, typename Alloc = std::allocator<char>>
+class NodeStorage{
+public:
+    using Index = uint32_t;
+    static constexpr Index npos = UINT32_MAX;
+
+    struct Link{
+        Index prev;
+        Index next;
+        uint32_t hash;  // 键哈希的低 32 位, 用作指纹
+        uint32_t count; // 访问次数 / 频次, 含义由使用者决定
+    };
+    static_assert(sizeof(Link) == 16, "Link should stay a 16-byte hot record");
+
+    // 双向链表头, 链表本身不占用节点槽位
+    struct List{
+        Index head = npos;
+        Index tail = npos;
+        size_t size = 0;
+        bool empty() const {return head == npos;}
+    };
+
+    explicit NodeStorage(size_t reserve = 0, const Alloc& alloc = Alloc())
+    : _links(alloc), _keys(alloc), _values(alloc), _free(alloc) {
+        _links.reserve(reserve);
+        _keys.reserve(reserve);
+        _values.reserve(reserve);
+    }
+
+    Index allocate(const Key& key, const Value& value, uint32_t hash) {
+        Index i;
+        if (!_free.empty()){
+            i = _free.back();
+            _free.pop_back();
+            _keys[i] = key;
+            _values[i] = value;
+        } else {
+            i = static_cast<Index>(_links.size());
+            _links.push_back(Link{});
+            _keys.push_back(key);
+            _values.push_back(value);
+        }
+        _links[i] = Link{npos, npos, hash, 1};
+        return i;
+    }
+
+    // 节点必须已经从所有链表中摘除; 键值立即析构, 空闲槽位不再持有大对象.
+    // 不能直接赋值 Value(): 移动赋值可能保留原来的缓冲区(如 libstdc++ 的 std::string), 这里移动构造到
+    // 临时对象上再让它析构, 缓冲区随之释放
+    void release(Index i) {
+        Key(std::move(_keys[i]));
+        Value(std::move(_values[i]));
+        _keys[i] = Key();
+        _values[i] = Value();
+        _free.push_back(i);
+    }
+
+    Link& link(Index i) {return _links[i];}
+    const Link& link(Index i) const {return _links[i];}
+    Key& key(Index i) {return _keys[i];}
+    Value& value(Index i) {return _values[i];}
+
+    size_t size() const {return _links.size() - _free.size();}
+
+    void pushBack(List& list, Index i) {
+        Link& node = _links[i];
+        node.prev = list.tail;
+        node.next = npos;
+        if (list.tail != npos) _links[list.tail].next = i;
+        else list.head = i;
+        list.tail = i;
+        ++list.size;
+    }
+
+    void pushFront(List& list, Index i) {
+        Link& node = _links[i];
+        node.prev = npos;
+        node.next = list.head;
+        if (list.head != npos) _links[list.head].prev = i;
+        else list.tail = i;
+        list.head = i;
+        ++list.size;
+    }
+
+    void unlink(List& list, Index i) {
+        Link& node = _links[i];
+        if (node.prev != npos) _links[node.prev].next = node.next;
+        else list.head = node.next;
+        if (node.next != npos) _links[node.next].prev = node.prev;
+        else list.tail = node.prev;
+        node.prev = node.next = npos;
+        --list.size;
+    }
+
+    void moveToBack(List& list, Index i) {
+        if (list.tail == i) return;
+        unlink(list, i);
+        pushBack(list, i);
+    }
+
+    void moveToFront(List& list, Index i) {
+        if (list.head == i) return;
+        unlink(list, i);
+        pushFront(list, i);
+    }
+
+private:
+    std::vector<Link, RebindAlloc<Alloc, Link>> _links;
+    std::vector<Key, RebindAlloc<Alloc, Key>> _keys;
+    std::vector<Value, RebindAlloc<Alloc, Value>> _values;
+    std::vector<Index, RebindAlloc<Alloc, Index>> _free;
+};
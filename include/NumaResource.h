@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory_resource>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// NUMA 拓扑: 从 /sys/devices/system/node 读取节点与 CPU 的对应关系
+// 读取失败(非 Linux、容器内不可见)时退化为单节点, 所有 CPU 都属于节点 0
+class NumaTopology{
+public:
+    static const NumaTopology& instance() {
+        static NumaTopology topology;
+        return topology;
+    }
+
+    int nodeCount() const {return _nodeCount;}
+
+    int nodeOfCpu(int cpu) const {
+        if (cpu < 0 || cpu >= static_cast<int>(_cpuToNode.size())) return 0;
+        return _cpuToNode[cpu];
+    }
+
+    // 当前线程所在的节点, 每个线程缓存结果, 每 1024 次调用重新查询一次(线程可能被迁移)
+    int currentNode() const {
+        if (_nodeCount <= 1) return 0;
+        thread_local int node = 0;
+        thread_local unsigned calls = 0;
+        if ((calls++ & 1023) == 0) {
+#ifdef __linux__
+            node = nodeOfCpu(sched_getcpu());
+#endif
+        }
+        return node;
+    }
+
+private:
+    NumaTopology() {
+        std::vector<int> nodes = parseList(readFile("/sys/devices/system/node/online"));
+        for (int node : nodes) {
+            for (int cpu : parseList(readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))) {
+                if (cpu >= static_cast<int>(_cpuToNode.size())) _cpuToNode.resize(cpu + 1, 0);
+                _cpuToNode[cpu] = node;
+            }
+        }
+        _nodeCount = nodes.empty() ? 1 : nodes.back() + 1;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream in(path);
+        std::string text;
+        std::getline(in, text);
+        return text;
+    }
+
+    // 解析 "0-3,8,10-11" 形式的列表
+    static std::vector<int> parseList(const std::string& text) {
+        std::vector<int> result;
+        std::stringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            if (item.empty()) continue;
+            size_t dash = item.find('-');
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int i = first; i <= last; ++i) result.push_back(i);
+        }
+        return result;
+    }
+
+private:
+    int _nodeCount = 1;
+    std::vector<int> _cpuToNode;
+};
+
+// 从指定 NUMA 节点分配内存的上游资源: mmap 后用 mbind(MPOL_PREFERRED) 绑定到节点
+// 每次分配都是一次 mmap, 应放在 pool 资源之下只提供大块内存.
+// 单节点机器或 mbind 不可用时直接使用 operator new
+class NumaMemoryResource : public std::pmr::memory_resource{
+public:
+    explicit NumaMemoryResource(int node)
+    : _node(node)
+    , _bind(node >= 0 && NumaTopology::instance().nodeCount() > 1)
+    {
+        // mbind 的节点掩码按 unsigned long 分字, 节点号可以超过一个字的位数
+        if (_bind) {
+            _nodeMask.assign(static_cast<size_t>(_node) / kMaskBits + 1, 0);
+            _nodeMask[_node / kMaskBits] |= 1ul << (_node % kMaskBits);
+        }
+    }
+
+    int node() const {return _node;}
+    bool bound() const {return _bind;}
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+#if defined(__linux__) && defined(SYS_mbind)
+        if (_bind) {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            const int kPreferred = 1; // MPOL_PREFERRED
+            // 内核先把 maxnode 减一再读掩码, 所以传位数 + 1
+            unsigned long maxNode = _nodeMask.size() * kMaskBits + 1;
+            syscall(SYS_mbind, p, bytes, kPreferred, _nodeMask.data(), maxNode, 0);
+            return p;
+        }
+#endif
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+#if defined(__linux__) && defined(SYS_mbind)
+        if (_bind) {
+            munmap(p, bytes);
+            return;
+        }
+#endif
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr int kMaskBits = static_cast<int>(sizeof(unsigned long) * 8);
+
+    int _node;
+    bool _bind;
+    std::vector<unsigned long> _nodeMask;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#include "caChePolicy.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "NumaResource.h"
+
+// 分片路由方式
+enum class NumaRouting{
+    Hash,  // 按键哈希选分片, 与 HashLruCache 相同
+    Local, // 只在调用线程所在节点的分片中按哈希选择, 适合键空间与线程绑定的场景
+};
+
+// NUMA 感知的分片缓存
+// 分片 i 放在节点 i % 节点数 上: 分片的节点存储与索引都从该节点的 NumaMemoryResource(外面套一层
+// pool 资源)分配. 每个分片统计命中、未命中, 以及来自本节点 / 其他节点线程的访问次数.
+// 单节点机器上所有分片都在节点 0, 行为与 HashLruCache 相同.
+// Policy 为 LruCache / LfuCache 这类 <Key, Value, Mutex, Alloc> 形式的缓存
+template<typename Key, typename Value, template<typename, typename, typename, typename> class Policy = LruCache>
+class NumaShardedCache : public caChepolicy<Key, Value>{
+public:
+    using Allocator = std::pmr::polymorphic_allocator<char>;
+    using Shard = Policy<Key, Value, std::mutex, Allocator>;
+
+    struct NodeStats{
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t localAccesses = 0;  // 访问线程与分片在同一节点
+        size_t remoteAccesses = 0; // 跨节点访问
+    };
+
+    // shardArgs 在容量之后、分配器之前传给分片的构造函数, 例如 LfuCache 的 maxAverageNum
+    template<typename... ShardArgs>
+    NumaShardedCache(size_t totalCapacity, int shardNum, NumaRouting routing, const ShardArgs&... shardArgs)
+    : _nodeCount(NumaTopology::instance().nodeCount())
+    , _shardNum(shardNum > 0 ? shardNum : _nodeCount)
+    , _routing(routing)
+    , _shards(_shardNum)
+    , _nodeShards(_nodeCount)
+    {
+        size_t shardSize = std::ceil(totalCapacity / static_cast<double>(_shardNum));
+        for (int i = 0; i < _shardNum; ++i) {
+            Slot& slot = _shards[i];
+            slot.node = i % _nodeCount;
+            slot.upstream = std::make_unique<NumaMemoryResource>(slot.node);
+            slot.pool = std::make_unique<std::pmr::synchronized_pool_resource>(slot.upstream.get());
+            slot.cache = std::make_unique<Shard>(shardSize, shardArgs..., Allocator(slot.pool.get()));
+            _nodeShards[slot.node].push_back(i);
+        }
+    }
+    ~NumaShardedCache() override = default;
+
+    void put(Key key, const Value& value) override {
+        Slot& slot = route(key);
+        slot.cache->put(key, value);
+    }
+
+    bool get(Key key, Value& value) override {
+        Slot& slot = route(key);
+        bool hit = slot.cache->get(key, value);
+        (hit ? slot.hits : slot.misses).fetch_add(1, std::memory_order_relaxed);
+        return hit;
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    int nodeCount() const {return _nodeCount;}
+
+    NodeStats nodeStats(int node) const {
+        NodeStats stats;
+        for (const Slot& slot : _shards) {
+            if (slot.node != node) continue;
+            stats.hits += slot.hits.load(std::memory_order_relaxed);
+            stats.misses += slot.misses.load(std::memory_order_relaxed);
+            stats.localAccesses += slot.local.load(std::memory_order_relaxed);
+            stats.remoteAccesses += slot.remote.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(64) Slot{
+        int node = 0;
+        std::unique_ptr<NumaMemoryResource> upstream;
+        std::unique_ptr<std::pmr::synchronized_pool_resource> pool;
+        std::unique_ptr<Shard> cache; // 析构顺序: 先缓存, 后资源
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+        std::atomic<size_t> local{0};
+        std::atomic<size_t> remote{0};
+    };
+
+    Slot& route(const Key& key) {
+        int node = NumaTopology::instance().currentNode();
+        size_t hash = std::hash<Key>{}(key);
+        const std::vector<int>& local = _nodeShards[node];
+        Slot& slot = (_routing == NumaRouting::Local && !local.empty())
+                   ? _shards[local[hash % local.size()]]
+                   : _shards[hash % _shardNum];
+        (slot.node == node ? slot.local : slot.remote).fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+private:
+    int _nodeCount;
+    int _shardNum;
+    NumaRouting _routing;
+    std::vector<Slot> _shards;
+    std::vector<std::vector<int>> _nodeShards; // 每个节点上的分片下标
+};
+
+template<typename Key, typename Value>
+using NumaHashLruCache = NumaShardedCache<Key, Value, LruCache>;
+
+template<typename Key, typename Value>
+using NumaHashLfuCache = NumaShardedCache<Key, Value, LfuCache>;
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "caChePolicy.h"
+#include "FrequencySketch.h"
+
+// Lamping & Veach 的跳跃一致性哈希: 分区数从 n 变为 n + 1 时只有约 1/(n + 1) 的键换分区
+inline int32_t jumpConsistentHash(uint64_t key, int32_t buckets) {
+    int64_t b = -1, j = 0;
+    while (j < buckets) {
+        b = j;
+        key = key * 2862933555777941757ULL + 1;
+        j = static_cast<int64_t>((b + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+    }
+    return static_cast<int32_t>(b);
+}
+
+// 缓存分区: 可以是本进程内的缓存, 也可以是其他进程中缓存的客户端(见 UnixSocketPartition.h)
+// 以批量接口为主, 远程分区一批请求只需一次往返
+template<typename Key, typename Value>
+class CachePartition{
+public:
+    virtual ~CachePartition() = default;
+    virtual void putBatch(const std::vector<std::pair<Key, Value>>& entries) = 0;
+    // values 与 found 按 keys 的顺序填写
+    virtual void getBatch(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<char>& found) = 0;
+    // 删除这些键(不存在的键忽略), 用于让副本失效
+    virtual void eraseBatch(const std::vector<Key>& keys) = 0;
+};
+
+// 缓存提供 remove(key) 时返回调用它的函数, 否则返回空函数: 这样的缓存作为分区时不能删除条目,
+// 不能用作热键复制的副本
+template<typename Key, typename Cache>
+auto cacheEraser(Cache& cache, int) -> decltype(cache.remove(std::declval<Key>()), std::function<void(const Key&)>()) {
+    return [&cache](const Key& key) {cache.remove(key);};
+}
+template<typename Key, typename Cache>
+std::function<void(const Key&)> cacheEraser(Cache&, long) {
+    return {};
+}
+
+// 本进程内的分区, 直接转发给一个已有的缓存
+template<typename Key, typename Value>
+class LocalPartition : public CachePartition<Key, Value>{
+public:
+    template<typename Cache>
+    explicit LocalPartition(Cache& cache)
+    : _cache(cache)
+    , _erase(cacheEraser<Key>(cache, 0))
+    {}
+
+    void putBatch(const std::vector<std::pair<Key, Value>>& entries) override {
+        for (const auto& entry : entries) _cache.put(entry.first, entry.second);
+    }
+    void getBatch(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<char>& found) override {
+        values.resize(keys.size());
+        found.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) found[i] = _cache.get(keys[i], values[i]);
+    }
+    void eraseBatch(const std::vector<Key>& keys) override {
+        if (!_erase) return;
+        for (const Key& key : keys) _erase(key);
+    }
+
+private:
+    caChepolicy<Key, Value>& _cache;
+    std::function<void(const Key&)> _erase;
+};
+
+// 一致性哈希分区缓存: 每个键只属于一个分区, 多个进程共用同一组分区时热键不再各存一份.
+// 可选的热键复制: 副本放在主分区之后的 replicas - 1 个分区上, 只由键决定, 所有进程看到的是同一组分区.
+// 写入只写主分区, 同时删除该键在副本分区上的条目(eraseBatch), 不论本进程是否认为它是热键, 所以另一个进程的
+// 写入也会让本进程读取的副本失效. 用 FrequencySketch 估计读频次, 热键的读取在主分区与副本之间轮流选择;
+// 副本未命中时回到主分区, 读到后写回该副本(读修复). 只有被读成热键的键才有副本, 冷键只存一份.
+// 读修复与其他进程对同一个键的写入并发时(读到主分区的旧值之后, 写入删除副本之前写回), 副本可能留下旧值,
+// 直到下一次写入该键或被淘汰; 与没有复制时一样不提供跨进程的写入顺序.
+// 分区需要支持 eraseBatch(LocalPartition 包装的缓存要有 remove), 否则副本不会失效.
+// 没有分区时所有读取未命中, 写入被丢弃.
+template<typename Key, typename Value>
+class PartitionedCache : public caChepolicy<Key, Value>{
+public:
+    using Partition = CachePartition<Key, Value>;
+
+    explicit PartitionedCache(std::vector<std::unique_ptr<Partition>> partitions)
+    : _partitions(std::move(partitions))
+    , _count(static_cast<int32_t>(_partitions.size()))
+    {}
+    ~PartitionedCache() override = default;
+
+    // replicas 为包括主分区在内的份数, hotThreshold 为判定热键的估计频次(sketch 计数上限 15)
+    void enableHotReplication(int replicas, uint8_t hotThreshold, size_t expectedKeys) {
+        _replicas = std::max(1, std::min(replicas, static_cast<int>(_count)));
+        _hotThreshold = hotThreshold;
+        _expectedKeys = expectedKeys > 0 ? expectedKeys : 1;
+        _sketch = std::make_unique<FrequencySketch>(_expectedKeys);
+    }
+
+    // 没有分区时返回 -1
+    int partitionOf(const Key& key) const {return jumpConsistentHash(mix(std::hash<Key>{}(key)), _count);}
+
+    void put(Key key, const Value& value) override {
+        if (_count == 0) return;
+        int primary = partitionOf(key);
+        _partitions[primary]->putBatch({{key, value}});
+        std::vector<Key> keys{key};
+        for (int r = 1; r < _replicas; ++r) _partitions[replicaOf(primary, r)]->eraseBatch(keys);
+    }
+
+    bool get(Key key, Value& value) override {
+        if (_count == 0) return false;
+        std::vector<Key> keys{key};
+        std::vector<Value> values;
+        std::vector<char> found;
+        int primary = partitionOf(key);
+        int partition = readTarget(key, primary);
+        _partitions[partition]->getBatch(keys, values, found);
+        if (!found[0] && partition != primary) {
+            _partitions[primary]->getBatch(keys, values, found);
+            if (found[0]) _partitions[partition]->putBatch({{key, values[0]}});
+        }
+        if (found[0]) value = std::move(values[0]);
+        return found[0];
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 按分区分组, 每个分区只发一批
+    void getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<char>& found) {
+        values.assign(keys.size(), Value{});
+        found.assign(keys.size(), 0);
+        if (_count == 0) return;
+        std::vector<std::vector<Key>> batches(_count);
+        std::vector<std::vector<size_t>> positions(_count);
+        std::vector<int> readFrom(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            int partition = readTarget(keys[i], partitionOf(keys[i]));
+            readFrom[i] = partition;
+            batches[partition].push_back(keys[i]);
+            positions[partition].push_back(i);
+        }
+        std::vector<Value> batchValues;
+        std::vector<char> batchFound;
+        std::vector<size_t> retry;
+        for (int32_t p = 0; p < _count; ++p) {
+            if (batches[p].empty()) continue;
+            _partitions[p]->getBatch(batches[p], batchValues, batchFound);
+            for (size_t i = 0; i < batches[p].size(); ++i) {
+                size_t pos = positions[p][i];
+                found[pos] = batchFound[i];
+                if (batchFound[i]) values[pos] = std::move(batchValues[i]);
+                else if (partitionOf(keys[pos]) != p) retry.push_back(pos);
+            }
+        }
+        // 副本未命中的热键按主分区分组重读, 读到的写回原来的副本
+        std::vector<std::vector<size_t>> retryPositions(_count);
+        for (size_t pos : retry) retryPositions[partitionOf(keys[pos])].push_back(pos);
+        std::vector<std::vector<std::pair<Key, Value>>> repairs(_count);
+        for (int32_t p = 0; p < _count; ++p) {
+            if (retryPositions[p].empty()) continue;
+            std::vector<Key> batch;
+            for (size_t pos : retryPositions[p]) batch.push_back(keys[pos]);
+            _partitions[p]->getBatch(batch, batchValues, batchFound);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                size_t pos = retryPositions[p][i];
+                found[pos] = batchFound[i];
+                if (!batchFound[i]) continue;
+                repairs[readFrom[pos]].push_back({keys[pos], batchValues[i]});
+                values[pos] = std::move(batchValues[i]);
+            }
+        }
+        for (int32_t p = 0; p < _count; ++p) {
+            if (!repairs[p].empty()) _partitions[p]->putBatch(repairs[p]);
+        }
+    }
+
+    void putMany(const std::vector<std::pair<Key, Value>>& entries) {
+        if (_count == 0) return;
+        std::vector<std::vector<std::pair<Key, Value>>> batches(_count);
+        std::vector<std::vector<Key>> invalidations(_count);
+        for (const auto& entry : entries) {
+            int primary = partitionOf(entry.first);
+            batches[primary].push_back(entry);
+            for (int r = 1; r < _replicas; ++r) invalidations[replicaOf(primary, r)].push_back(entry.first);
+        }
+        for (int32_t p = 0; p < _count; ++p) {
+            if (!batches[p].empty()) _partitions[p]->putBatch(batches[p]);
+            if (!invalidations[p].empty()) _partitions[p]->eraseBatch(invalidations[p]);
+        }
+    }
+
+private:
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    bool isHot(const Key& key) const {
+        return _sketch->estimate(std::hash<Key>{}(key)) >= _hotThreshold;
+    }
+
+    // 第 r 个副本所在的分区(r = 0 为主分区), 只由键的主分区决定
+    int replicaOf(int primary, int r) const {return (primary + r) % _count;}
+
+    int readTarget(const Key& key, int primary) {
+        if (_replicas <= 1) return primary;
+        _sketch->increment(std::hash<Key>{}(key));
+        // 样本数达到预期键数的 10 倍时减半, 只让一个线程做
+        if (_sketch->additions() >= _expectedKeys * 10) {
+            std::unique_lock<std::mutex> lock(_agingMutex, std::try_to_lock);
+            if (lock.owns_lock() && _sketch->additions() >= _expectedKeys * 10) _sketch->age(SIZE_MAX);
+        }
+        if (!isHot(key)) return primary;
+        thread_local unsigned turn = 0;
+        return replicaOf(primary, static_cast<int>(turn++ % _replicas));
+    }
+
+private:
+    std::vector<std::unique_ptr<Partition>> _partitions;
+    int32_t _count;
+    int _replicas = 1;
+    uint8_t _hotThreshold = FrequencySketch::kMaxCount;
+    size_t _expectedKeys = 1;
+    std::unique_ptr<FrequencySketch> _sketch;
+    std::mutex _agingMutex;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "LruCache.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 每核独占的缓存 + 按 key 哈希路由
+// 每个核(线程)拥有一个不加锁的缓存分片, 只有该核会访问它;
+// 访问其他核的 key 时, 请求经过 [发送核][目标核] 这条 SPSC 队列转发给目标核执行.
+// 约定: 每个 core 编号只能由一个线程使用, 且该线程需要周期性调用 poll(core)
+template<typename Key, typename Value, typename CacheType = LruCache<Key, Value, NullMutex>>
+class PerCoreCache{
+public:
+    PerCoreCache(size_t totalCapacity, size_t coreNum, size_t queueDepth = 1024)
+    : _coreNum(coreNum > 0 ? coreNum : std::thread::hardware_concurrency())
+    {
+        size_t sliceSize = std::ceil(totalCapacity / static_cast<double>(_coreNum));
+        for (size_t i = 0; i < _coreNum; ++i){
+            _caches.emplace_back(std::make_unique<CacheType>(sliceSize));
+        }
+        for (size_t i = 0; i < _coreNum * _coreNum; ++i){
+            _queues.emplace_back(std::make_unique<SpscQueue<Message>>(queueDepth));
+        }
+    }
+
+    size_t owner(const Key& key) const {return std::hash<Key>{}(key) % _coreNum;}
+    size_t coreNum() const {return _coreNum;}
+    // 仅 core 对应的线程可以直接访问
+    CacheType& local(size_t core) {return *_caches[core];}
+
+    // 远端 key 同步等待结果, 等待期间继续处理发给本核的请求, 避免互相等待造成死锁
+    bool get(size_t core, const Key& key, Value& value) {
+        size_t target = owner(key);
+        if (target == core) return _caches[core]->get(key, value);
+        Reply reply;
+        send(core, target, Message{Op::Get, key, Value{}, &reply});
+        while (!reply.done.load(std::memory_order_acquire)){
+            if (poll(core) == 0) std::this_thread::yield();
+        }
+        if (reply.found) value = std::move(reply.value);
+        return reply.found;
+    }
+
+    // 远端 put 异步执行; 同一对核之间的队列保序, 之后的 get 能读到本次写入
+    void put(size_t core, const Key& key, const Value& value) {
+        size_t target = owner(key);
+        if (target == core){
+            _caches[core]->put(key, value);
+            return;
+        }
+        send(core, target, Message{Op::Put, key, value, nullptr});
+    }
+
+    // 处理其他核发给 core 的请求, 返回处理数量
+    size_t poll(size_t core) {
+        size_t handled = 0;
+        Message msg;
+        for (size_t from = 0; from < _coreNum; ++from){
+            if (from == core) continue;
+            SpscQueue<Message>& queue = *_queues[from * _coreNum + core];
+            while (queue.pop(msg)){
+                handle(core, msg);
+                ++handled;
+            }
+        }
+        return handled;
+    }
+
+private:
+    enum class Op {Get, Put};
+    struct Reply{
+        std::atomic<bool> done{false};
+        bool found = false;
+        Value value{};
+    };
+    struct Message{
+        Op op = Op::Get;
+        Key key{};
+        Value value{};
+        Reply* reply = nullptr;
+    };
+
+    void send(size_t from, size_t to, Message msg) {
+        SpscQueue<Message>& queue = *_queues[from * _coreNum + to];
+        while (!queue.push(msg)){
+            if (poll(from) == 0) std::this_thread::yield();
+        }
+    }
+
+    void handle(size_t core, Message& msg) {
+        if (msg.op == Op::Put){
+            _caches[core]->put(msg.key, msg.value);
+            return;
+        }
+        Reply* reply = msg.reply;
+        reply->found = _caches[core]->get(msg.key, reply->value);
+        reply->done.store(true, std::memory_order_release);
+    }
+
+private:
+    size_t _coreNum;
+    std::vector<std::unique_ptr<CacheType>> _caches;
+    std::vector<std::unique_ptr<SpscQueue<Message>>> _queues; // 下标 from * coreNum + to
+};
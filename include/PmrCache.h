@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory_resource>
+
+#include "ArcCache.h"
+#include "HashLfuCache.h"
+#include "HashLruCache.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "LruKCache.h"
+
+// 使用 std::pmr 内存资源的缓存别名
+// 节点存储、键索引、频次链表、幽灵表全部从构造时传入的 memory_resource 分配; 值类型本身是
+// pmr 类型(如 std::pmr::string)时, 通过 uses-allocator 构造同样落在该资源上.
+// 典型用法:
+//   monotonic_buffer_resource  请求级的临时缓存, 析构后整体释放资源, 不逐个归还节点
+//   unsynchronized_pool_resource / synchronized_pool_resource  长期存在的缓存
+//   NUMA 本地资源  绑定到某个节点的分片
+// 资源的生命周期必须长于缓存.
+namespace pmr{
+
+using Allocator = std::pmr::polymorphic_allocator<char>;
+
+template<typename Key, typename Value, typename Mutex = std::mutex>
+using LruCache = ::LruCache<Key, Value, Mutex, Allocator>;
+
+template<typename Key, typename Value>
+using LruKCache = ::LruKCache<Key, Value, Allocator>;
+
+template<typename Key, typename Value, typename Mutex = std::mutex>
+using LfuCache = ::LfuCache<Key, Value, Mutex, Allocator>;
+
+template<typename Key, typename Value, typename Mutex = std::mutex>
+using ArcCache = ::ArcCahce<Key, Value, Mutex, Allocator>;
+
+// 分片共用同一个资源, 多线程访问不同分片时要用 synchronized_pool_resource 这类线程安全的资源
+template<typename Key, typename Value>
+using HashLruCache = ::HashLruCache<Key, Value, Allocator>;
+
+template<typename Key, typename Value>
+using HashLfuCache = ::HashLfuCache<Key, Value, LfuCache<Key, Value>>;
+
+} // namespace pmr
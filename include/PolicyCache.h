@@ -0,0 +1,160 @@
+#pragma once
+
+#include "caChePolicy.h"
+#include "CacheEviction.h"
+#include "CacheIndex.h"
+#include "CacheLocking.h"
+#include "CacheStats.h"
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+// 基于策略组合的缓存: 淘汰算法、索引、加锁方式和统计都在编译期确定
+// 没有虚函数, 单线程 + NoStats 配置下 get/put 可以被完全内联
+//   Cache<int, std::string>                                         LRU, 不加锁, 不统计
+//   Cache<int, std::string, LfuEviction, HashIndex, MutexLocking>   LFU, 单把互斥锁
+//   Cache<int, std::string, ClockEviction, HashIndex, RWLocking, CountingStats>
+template<typename Key, typename Value,
+         template<typename, typename> class Eviction = LruEviction,
+         template<typename, typename> class Index = HashIndex,
+         typename Locking = NoLocking,
+         typename Stats = NoStats>
+class Cache : private Stats{
+public:
+    using KeyType = Key;
+    using ValueType = Value;
+    using EvictionType = Eviction<Key, Value>;
+    using Node = typename EvictionType::Node;
+    using IndexType = Index<Key, Node>;
+
+    explicit Cache(size_t capacity)
+    : _capacity(capacity)
+    {
+        size_t shardCapacity = std::ceil(capacity / static_cast<double>(Locking::kStripes));
+        for (auto& shard : _shards){
+            shard.capacity = shardCapacity;
+            shard.index.reserve(shardCapacity);
+        }
+    }
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    void put(const Key& key, const Value& value) {
+        if (_capacity == 0) return;
+        Shard& shard = shardFor(key);
+        typename Locking::WriteGuard guard(shard.mutex);
+        recorder().onPut();
+        Node* node = shard.index.find(key);
+        if (node){
+            node->value = value;
+            shard.eviction.touch(node);
+            return;
+        }
+        if (shard.index.size() >= shard.capacity) evict(shard);
+        shard.index.insert(key, shard.eviction.insert(key, value));
+    }
+
+    bool get(const Key& key, Value& value) {
+        Shard& shard = shardFor(key);
+        if constexpr (EvictionType::kConcurrentTouch){
+            typename Locking::ReadGuard guard(shard.mutex);
+            return lookup(shard, key, value);
+        } else {
+            typename Locking::WriteGuard guard(shard.mutex);
+            return lookup(shard, key, value);
+        }
+    }
+
+    Value get(const Key& key) {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    bool remove(const Key& key) {
+        Shard& shard = shardFor(key);
+        typename Locking::WriteGuard guard(shard.mutex);
+        Node* node = shard.index.find(key);
+        if (!node) return false;
+        shard.index.erase(key);
+        shard.eviction.erase(node);
+        return true;
+    }
+
+    size_t size() {
+        size_t total = 0;
+        for (auto& shard : _shards){
+            typename Locking::WriteGuard guard(shard.mutex);
+            total += shard.index.size();
+        }
+        return total;
+    }
+    size_t capacity() const {return _capacity;}
+    const Stats& stats() const {return *this;}
+
+private:
+    struct Shard{
+        typename Locking::Mutex mutex;
+        size_t capacity = 0;
+        IndexType index;
+        EvictionType eviction;
+    };
+
+    Stats& recorder() {return *this;}
+
+    Shard& shardFor(const Key& key) {
+        if constexpr (Locking::kStripes == 1){
+            return _shards[0];
+        } else {
+            return _shards[std::hash<Key>{}(key) % Locking::kStripes];
+        }
+    }
+
+    bool lookup(Shard& shard, const Key& key, Value& value) {
+        Node* node = shard.index.find(key);
+        if (!node){
+            recorder().onMiss();
+            return false;
+        }
+        shard.eviction.touch(node);
+        value = node->value;
+        recorder().onHit();
+        return true;
+    }
+
+    void evict(Shard& shard) {
+        Node* victim = shard.eviction.victim();
+        if (!victim) return;
+        shard.index.erase(victim->key);
+        shard.eviction.erase(victim);
+        recorder().onEvict();
+    }
+
+private:
+    size_t _capacity;
+    std::array<Shard, Locking::kStripes> _shards;
+};
+
+// 虚接口适配器, 让组合出的缓存可以放进现有的 caChepolicy 测试框架
+template<typename CacheType>
+class PolicyCacheAdapter : public caChepolicy<typename CacheType::KeyType, typename CacheType::ValueType>{
+public:
+    using Key = typename CacheType::KeyType;
+    using Value = typename CacheType::ValueType;
+
+    template<typename... Args>
+    explicit PolicyCacheAdapter(Args&&... args)
+    : _cache(std::forward<Args>(args)...)
+    {}
+    ~PolicyCacheAdapter() override = default;
+
+    void put(Key key, const Value& value) override {_cache.put(key, value);}
+    bool get(Key key, Value& value) override {return _cache.get(key, value);}
+    Value get(Key key) override {return _cache.get(key);}
+
+    CacheType& cache() {return _cache;}
+private:
+    CacheType _cache;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 条目被移除的原因
+enum class RemovalCause{
+    Capacity,   // 容量不足被淘汰
+    Expired,    // 过期
+    Explicit,   // 调用 remove 主动删除
+    Replaced,   // 被 put 覆盖, 通知中携带旧值
+};
+
+template<typename Key, typename Value>
+struct RemovalNotification{
+    Key key;
+    Value value;
+    RemovalCause cause;
+};
+
+// 移除通知的缓冲与批量投递
+// record() 在缓存锁内调用, 只做一次追加; dispatch() 在缓存锁外调用, 缓冲达到批量大小时
+// 交给监听器. 同一时刻只有一个线程在投递, 批次之间保持顺序, 慢监听器不会拉长缓存的临界区
+template<typename Key, typename Value>
+class RemovalNotifier{
+public:
+    using Notification = RemovalNotification<Key, Value>;
+    using Listener = std::function<void(const std::vector<Notification>&)>;
+
+    RemovalNotifier() = default;
+    RemovalNotifier(const RemovalNotifier&) = delete;
+    RemovalNotifier& operator=(const RemovalNotifier&) = delete;
+
+    void setListener(Listener listener, size_t batchSize) {
+        std::lock_guard<std::mutex> delivery(_deliveryMutex);
+        _listener = std::move(listener);
+        _batchSize = batchSize > 0 ? batchSize : 1;
+        _enabled.store(static_cast<bool>(_listener), std::memory_order_release);
+    }
+
+    // 未设置监听器时缓存可以跳过构造通知
+    bool enabled() const {return _enabled.load(std::memory_order_acquire);}
+
+    void record(const Key& key, const Value& value, RemovalCause cause) {
+        std::lock_guard<std::mutex> lock(_bufferMutex);
+        _buffer.push_back(Notification{key, value, cause});
+    }
+
+    // 缓冲达到批量时投递; 已有线程在投递时直接返回, 由它继续处理
+    void dispatch() {
+        if (!enabled()) return;
+        std::unique_lock<std::mutex> delivery(_deliveryMutex, std::try_to_lock);
+        if (!delivery.owns_lock()) return;
+        deliver(false);
+    }
+
+    // 投递全部剩余通知
+    void flush() {
+        std::lock_guard<std::mutex> delivery(_deliveryMutex);
+        deliver(true);
+    }
+
+private:
+    void deliver(bool force) {
+        std::vector<Notification> batch;
+        while (true){
+            {
+                std::lock_guard<std::mutex> lock(_bufferMutex);
+                if (_buffer.empty() || (!force && _buffer.size() < _batchSize)) return;
+                batch.swap(_buffer);
+            }
+            if (_listener) _listener(batch);
+            batch.clear();
+        }
+    }
+
+private:
+    std::atomic<bool> _enabled{false};
+    std::mutex _deliveryMutex; // 保护 _listener, 串行化投递
+    Listener _listener;
+    size_t _batchSize = 1;
+    std::mutex _bufferMutex;
+    std::vector<Notification> _buffer;
+};
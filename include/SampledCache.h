@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "caChePolicy.h"
+#include "CacheAllocator.h"
+
+enum class SampledPolicy{
+    Lru, // 24 位访问时钟, 淘汰空闲最久的
+    Lfu, // 8 位对数计数器 + 16 位衰减时间, 淘汰计数最小的
+};
+
+// 采样近似 LRU / LFU(与 Redis 的 maxmemory 策略相同的思路)
+// 键值直接放在开放寻址(线性探测)的扁平表里, 没有链表和额外节点, 命中时只改写槽位上的 24 位元数据.
+// 每个槽位的控制字为 4 字节: 高 8 位是哈希 tag(0 表示空槽), 低 24 位是时钟或计数器.
+// 淘汰时从随机位置起取 samples 个非空槽位, 按得分放进一个 16 项的候选池, 淘汰池中得分最高的;
+// 候选池跨多次淘汰保留, samples 较小时也能逼近精确 LRU / LFU.
+// 删除使用向后移位, 表中没有墓碑.
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>>
+class SampledCache : public caChepolicy<Key, Value>{
+public:
+    static constexpr int kPoolSize = 16;
+
+    SampledCache(int capacity, SampledPolicy policy = SampledPolicy::Lru, int samples = 5, const Alloc& alloc = Alloc())
+    : _capacity(capacity > 0 ? capacity : 0)
+    , _policy(policy)
+    , _samples(samples > 0 ? samples : 1)
+    , _mask(tableSize(_capacity) - 1)
+    , _ctrl(_mask + 1, 0, alloc)
+    , _keys(_mask + 1, Key{}, alloc)
+    , _values(_mask + 1, Value{}, alloc)
+    {
+        // LFU 计数器每经过约 32 倍容量次访问衰减 1
+        while ((1ull << _decayShift) < (static_cast<uint64_t>(_capacity) << 5) && _decayShift < 24) ++_decayShift;
+    }
+    ~SampledCache() override = default;
+
+    void put(Key key, const Value& value) override {
+        if (_capacity == 0) return;
+        std::lock_guard<Mutex> lock(_mutex);
+        ++_clock;
+        uint64_t h = mix(std::hash<Key>{}(key));
+        size_t slot = find(key, h);
+        if (slot != npos) {
+            _values[slot] = value;
+            touch(slot);
+            return;
+        }
+        if (_size >= static_cast<size_t>(_capacity)) evictOne();
+        slot = h & _mask;
+        while (tagOf(_ctrl[slot]) != 0) slot = (slot + 1) & _mask;
+        _keys[slot] = key;
+        _values[slot] = value;
+        uint32_t meta = _policy == SampledPolicy::Lru ? (_clock & kMetaMask) : lfuMeta(kLfuInitValue);
+        _ctrl[slot] = (static_cast<uint32_t>(tagOf(h)) << 24) | meta;
+        ++_size;
+    }
+
+    bool get(Key key, Value& value) override {
+        std::lock_guard<Mutex> lock(_mutex);
+        ++_clock;
+        size_t slot = find(key, mix(std::hash<Key>{}(key)));
+        if (slot == npos) return false;
+        touch(slot);
+        value = _values[slot];
+        return true;
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    void remove(Key key) {
+        std::lock_guard<Mutex> lock(_mutex);
+        size_t slot = find(key, mix(std::hash<Key>{}(key)));
+        if (slot != npos) erase(slot);
+    }
+
+    size_t size() const {return _size;}
+
+private:
+    static constexpr size_t npos = SIZE_MAX;
+    static constexpr uint32_t kMetaMask = 0xFFFFFF;
+    static constexpr uint32_t kLfuInitValue = 5; // 新键的初始计数, 避免刚写入就被淘汰
+    static constexpr uint32_t kLfuLogFactor = 10;
+
+    struct Candidate{
+        Key key;
+        uint32_t score; // 越大越应该被淘汰
+    };
+
+    // 负载因子不超过 3/4
+    static size_t tableSize(size_t capacity) {
+        size_t need = capacity + capacity / 3 + 1;
+        size_t n = 1;
+        while (n < need) n <<= 1;
+        return n;
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+    static uint8_t tagOf(uint64_t h) {return static_cast<uint8_t>((h >> 56) | 0x80);}
+    static uint8_t tagOf(uint32_t ctrl) {return static_cast<uint8_t>(ctrl >> 24);}
+
+    size_t find(const Key& key, uint64_t h) const {
+        uint8_t tag = tagOf(h);
+        for (size_t slot = h & _mask; ; slot = (slot + 1) & _mask) {
+            uint8_t t = tagOf(_ctrl[slot]);
+            if (t == 0) return npos;
+            if (t == tag && _keys[slot] == key) return slot;
+        }
+    }
+
+    // 向后移位删除: 把后续探测链上能前移的条目搬到空出的位置
+    void erase(size_t hole) {
+        for (size_t next = (hole + 1) & _mask; tagOf(_ctrl[next]) != 0; next = (next + 1) & _mask) {
+            size_t home = mix(std::hash<Key>{}(_keys[next])) & _mask;
+            bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+            if (stays) continue;
+            _ctrl[hole] = _ctrl[next];
+            _keys[hole] = std::move(_keys[next]);
+            _values[hole] = std::move(_values[next]);
+            hole = next;
+        }
+        _ctrl[hole] = 0;
+        _keys[hole] = Key{};
+        _values[hole] = Value{};
+        --_size;
+    }
+
+    void touch(size_t slot) {
+        uint32_t meta;
+        if (_policy == SampledPolicy::Lru) {
+            meta = _clock & kMetaMask;
+        } else {
+            uint32_t counter = decayedCounter(_ctrl[slot]);
+            if (counter < 255) {
+                // Morris 计数: 计数越大, 再加 1 的概率越小
+                double base = counter > kLfuInitValue ? counter - kLfuInitValue : 0;
+                if (random01() < 1.0 / (base * kLfuLogFactor + 1)) ++counter;
+            }
+            meta = lfuMeta(counter);
+        }
+        _ctrl[slot] = (_ctrl[slot] & ~kMetaMask) | meta;
+    }
+
+    uint32_t decayTime() const {return (_clock >> _decayShift) & 0xFFFF;}
+    uint32_t lfuMeta(uint32_t counter) const {return (decayTime() << 8) | counter;}
+
+    uint32_t decayedCounter(uint32_t ctrl) const {
+        uint32_t counter = ctrl & 0xFF;
+        uint32_t elapsed = (decayTime() - ((ctrl >> 8) & 0xFFFF)) & 0xFFFF;
+        return elapsed >= counter ? 0 : counter - elapsed;
+    }
+
+    uint32_t score(size_t slot) const {
+        if (_policy == SampledPolicy::Lru) return (_clock - _ctrl[slot]) & kMetaMask;
+        return 255 - decayedCounter(_ctrl[slot]);
+    }
+
+    double random01() {
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 7;
+        _seed ^= _seed << 17;
+        return (_seed >> 11) * 0x1.0p-53;
+    }
+
+    // 候选池按得分升序排列, 已在池中的键只更新得分
+    void offer(const Key& key, uint32_t score) {
+        for (int i = 0; i < _poolSize; ++i) {
+            if (_pool[i].key == key) {
+                dropCandidate(i);
+                break;
+            }
+        }
+        if (_poolSize == kPoolSize) {
+            if (score <= _pool[0].score) return;
+            dropCandidate(0);
+        }
+        int pos = _poolSize;
+        while (pos > 0 && _pool[pos - 1].score > score) {
+            _pool[pos] = std::move(_pool[pos - 1]);
+            --pos;
+        }
+        _pool[pos] = Candidate{key, score};
+        ++_poolSize;
+    }
+
+    void dropCandidate(int i) {
+        for (; i + 1 < _poolSize; ++i) _pool[i] = std::move(_pool[i + 1]);
+        --_poolSize;
+    }
+
+    void populatePool() {
+        size_t start = static_cast<size_t>(random01() * (_mask + 1)) & _mask;
+        int taken = 0;
+        for (size_t i = 0; i <= _mask && taken < _samples; ++i) {
+            size_t slot = (start + i) & _mask;
+            if (tagOf(_ctrl[slot]) == 0) continue;
+            offer(_keys[slot], score(slot));
+            ++taken;
+        }
+    }
+
+    void evictOne() {
+        while (_size > 0) {
+            populatePool();
+            if (_poolSize == 0) return;
+            Candidate best = std::move(_pool[_poolSize - 1]);
+            --_poolSize;
+            size_t slot = find(best.key, mix(std::hash<Key>{}(best.key)));
+            if (slot == npos) continue; // 已被删除或淘汰
+            // 进入候选池后又被访问过, 按新得分放回
+            uint32_t now = score(slot);
+            if (now < best.score && _poolSize > 0 && now < _pool[_poolSize - 1].score) {
+                offer(best.key, now);
+                continue;
+            }
+            erase(slot);
+            return;
+        }
+    }
+
+private:
+    int _capacity;
+    SampledPolicy _policy;
+    int _samples;
+    size_t _mask;
+    std::vector<uint32_t, RebindAlloc<Alloc, uint32_t>> _ctrl;
+    std::vector<Key, RebindAlloc<Alloc, Key>> _keys;
+    std::vector<Value, RebindAlloc<Alloc, Value>> _values;
+    size_t _size = 0;
+    uint32_t _clock = 0;
+    int _decayShift = 15;
+    uint64_t _seed = 0x9E3779B97F4A7C15ULL;
+    Candidate _pool[kPoolSize] = {};
+    int _poolSize = 0;
+    Mutex _mutex;
+};
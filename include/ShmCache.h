@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "caChePolicy.h"
+
+// 值在共享内存槽位中的编码: std::string 存原始字节, 其他类型须可平凡复制, 按字节存储
+template<typename T, typename Enable = void>
+struct ShmCodec{
+    static_assert(std::is_trivially_copyable<T>::value, "ShmCache 的值必须可平凡复制或为 std::string");
+    static size_t size(const T&) {return sizeof(T);}
+    static void write(const T& value, char* out) {std::memcpy(out, &value, sizeof(T));}
+    static bool read(const char* in, size_t length, T& value) {
+        if (length != sizeof(T)) return false;
+        std::memcpy(&value, in, sizeof(T));
+        return true;
+    }
+};
+
+template<>
+struct ShmCodec<std::string>{
+    static size_t size(const std::string& value) {return value.size();}
+    static void write(const std::string& value, char* out) {std::memcpy(out, value.data(), value.size());}
+    static bool read(const char* in, size_t length, std::string& value) {
+        value.assign(in, length);
+        return true;
+    }
+};
+
+enum class ShmBacking{
+    SharedMemory, // shm_open 创建的共享内存段
+    File,         // 内存映射的普通文件
+};
+
+// 放在 POSIX 共享内存段中的缓存, 同一台机器上的多个进程打开同一个名字即共用一份缓存
+// 段内只使用偏移量与槽位下标, 不存放指针, 各进程可以把段映射到不同的地址.
+// 每个分片: 进程间共享的健壮互斥锁(PTHREAD_MUTEX_ROBUST) + 序列锁 + 链式哈希桶 + 定长槽位(CLOCK 淘汰).
+// 写入持锁进行, 修改前后各把序列号加一; 读取不加锁, 按序列号校验读到的数据, 校验失败几次后改为加锁读取.
+// 持锁的进程崩溃后, 下一个加锁的进程拿到 EOWNERDEAD, 此时分片可能处于修改到一半的状态, 直接清空该分片
+// 再标记锁为一致(缓存可以丢弃内容). 键须可平凡复制, 值最多 valueBytes 字节, 更大的值不缓存.
+// 所有进程必须运行同一份程序(std::hash 与类型布局一致).
+template<typename Key, typename Value>
+class ShmCache : public caChepolicy<Key, Value>{
+    static_assert(std::is_trivially_copyable<Key>::value, "ShmCache 的键必须可平凡复制");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "共享内存中的原子变量必须无锁");
+
+public:
+    // 段 name 不存在时按参数创建, 已存在时直接打开, 参数以段中记录的为准.
+    // SharedMemory: name 为 POSIX 共享内存名(以 '/' 开头); File: name 为普通文件路径,
+    // 内容由内核按页写回磁盘, 可以作为比内存大的溢出层(见 TieredCache.h)
+    ShmCache(const std::string& name, size_t capacity, int shardNum, size_t valueBytes,
+             ShmBacking backing = ShmBacking::SharedMemory) {
+        int fd = openSegment(name, backing, O_RDWR | O_CREAT | O_EXCL);
+        if (fd >= 0) {
+            create(fd, capacity, shardNum, valueBytes);
+        } else if (errno == EEXIST) {
+            fd = openSegment(name, backing, O_RDWR);
+            if (fd >= 0) attach(fd);
+        }
+        if (fd >= 0) ::close(fd);
+    }
+    ~ShmCache() override {
+        if (_base) ::munmap(_base, _bytes);
+    }
+
+    ShmCache(const ShmCache&) = delete;
+    ShmCache& operator=(const ShmCache&) = delete;
+
+    // 删除段的名字; 已经打开的进程不受影响, 最后一个进程解除映射后内存才释放
+    static bool unlink(const std::string& name, ShmBacking backing = ShmBacking::SharedMemory) {
+        return (backing == ShmBacking::File ? ::unlink(name.c_str()) : ::shm_unlink(name.c_str())) == 0;
+    }
+
+    bool attached() const {return _base != nullptr;}
+    size_t bytes() const {return _bytes;}
+    size_t capacity() const {return _base ? static_cast<size_t>(header().shards) * header().slots : 0;}
+
+    void put(Key key, const Value& value) override {
+        if (!_base) return;
+        uint64_t h = hashOf(key);
+        Shard& shard = shardOf(h);
+        size_t length = ShmCodec<Value>::size(value);
+        lock(shard);
+        beginWrite(shard);
+        uint32_t slot = find(shard, h, key);
+        if (length > header().valueBytes) {
+            // 放不下的值不缓存, 同时删掉旧值, 避免读到过期数据
+            if (slot != npos) erase(shard, slot);
+        } else {
+            if (slot == npos) slot = insert(shard, h, key);
+            SlotHeader& meta = slotHeader(shard, slot);
+            ShmCodec<Value>::write(value, valueOf(shard, slot));
+            meta.length.store(static_cast<uint32_t>(length), std::memory_order_relaxed);
+            meta.referenced.store(1, std::memory_order_relaxed);
+        }
+        endWrite(shard);
+        unlock(shard);
+    }
+
+    bool get(Key key, Value& value) override {
+        if (!_base) return false;
+        uint64_t h = hashOf(key);
+        Shard& shard = shardOf(h);
+        thread_local std::string buffer;
+        buffer.resize(header().valueBytes);
+        for (int attempt = 0; attempt < kOptimisticReads; ++attempt) {
+            uint32_t before = shard.seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            uint32_t length = 0;
+            bool found = readSlot(shard, h, key, &buffer[0], length);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (shard.seq.load(std::memory_order_relaxed) == before) {
+                return found && ShmCodec<Value>::read(buffer.data(), length, value);
+            }
+        }
+        // 写入频繁或写入方崩溃(序列号停在奇数)时加锁读取
+        lock(shard);
+        uint32_t length = 0;
+        bool found = readSlot(shard, h, key, &buffer[0], length);
+        unlock(shard);
+        return found && ShmCodec<Value>::read(buffer.data(), length, value);
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    bool remove(const Key& key) {
+        if (!_base) return false;
+        uint64_t h = hashOf(key);
+        Shard& shard = shardOf(h);
+        lock(shard);
+        beginWrite(shard);
+        uint32_t slot = find(shard, h, key);
+        if (slot != npos) erase(shard, slot);
+        endWrite(shard);
+        unlock(shard);
+        return slot != npos;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (uint32_t i = 0; _base && i < header().shards; ++i) total += shardAt(i).size;
+        return total;
+    }
+
+    // 因持锁进程崩溃而被清空的分片次数(所有进程合计)
+    uint64_t recoveries() const {
+        uint64_t total = 0;
+        for (uint32_t i = 0; _base && i < header().shards; ++i) {
+            total += shardAt(i).recoveries.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    static constexpr uint64_t kMagic = 0x53484D4341434801ULL; // 末字节为格式版本
+    static constexpr uint32_t npos = UINT32_MAX;
+    static constexpr int kOptimisticReads = 4;
+
+    struct Header{
+        std::atomic<uint64_t> magic;  // 创建者初始化完成后最后写入
+        uint64_t bytes;
+        uint64_t shardOffset;
+        uint32_t shards;
+        uint32_t slots;               // 每个分片的槽位数
+        uint32_t buckets;             // 每个分片的桶数, 2 的幂
+        uint32_t valueBytes;
+        uint32_t slotBytes;
+    };
+
+    struct alignas(64) Shard{
+        pthread_mutex_t mutex;
+        std::atomic<uint32_t> seq;    // 奇数表示正在修改
+        uint32_t size;
+        uint32_t hand;                // CLOCK 指针
+        uint32_t freeHead;
+        uint64_t bucketOffset;
+        uint64_t slotOffset;
+        std::atomic<uint64_t> recoveries;
+    };
+
+    struct SlotHeader{
+        std::atomic<uint64_t> hash;
+        std::atomic<uint32_t> next;   // 桶内链表或空闲链表中的下一个槽位
+        std::atomic<uint32_t> length;
+        std::atomic<uint8_t> referenced;
+        uint8_t used;
+    };
+
+    static int openSegment(const std::string& name, ShmBacking backing, int flags) {
+        if (backing == ShmBacking::File) return ::open(name.c_str(), flags | O_CLOEXEC, 0600);
+        return ::shm_open(name.c_str(), flags, 0600);
+    }
+
+    static size_t alignUp(size_t n, size_t a) {return (n + a - 1) / a * a;}
+
+    static uint64_t hashOf(const Key& key) {
+        uint64_t x = std::hash<Key>{}(key);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    void create(int fd, size_t capacity, int shardNum, size_t valueBytes) {
+        uint32_t shards = static_cast<uint32_t>(shardNum > 0 ? shardNum : 1);
+        uint32_t slots = static_cast<uint32_t>(std::max<size_t>((capacity + shards - 1) / shards, 1));
+        uint32_t buckets = 1;
+        while (buckets < slots) buckets <<= 1;
+        uint32_t slotBytes = static_cast<uint32_t>(alignUp(sizeof(SlotHeader) + sizeof(Key) + valueBytes, 8));
+
+        size_t shardOffset = alignUp(sizeof(Header), 64);
+        size_t offset = shardOffset + sizeof(Shard) * shards;
+        size_t bucketBytes = alignUp(sizeof(uint32_t) * buckets, 64);
+        size_t bytes = offset + (bucketBytes + static_cast<size_t>(slotBytes) * slots) * shards;
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0 || !map(fd, bytes)) return;
+
+        // ftruncate 得到的内存全为 0, 原子变量与计数器不需要再初始化
+        Header& head = header();
+        head.bytes = bytes;
+        head.shardOffset = shardOffset;
+        head.shards = shards;
+        head.slots = slots;
+        head.buckets = buckets;
+        head.valueBytes = static_cast<uint32_t>(valueBytes);
+        head.slotBytes = slotBytes;
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        for (uint32_t i = 0; i < shards; ++i) {
+            Shard& shard = shardAt(i);
+            pthread_mutex_init(&shard.mutex, &attr);
+            shard.bucketOffset = offset;
+            shard.slotOffset = offset + bucketBytes;
+            offset += bucketBytes + static_cast<size_t>(slotBytes) * slots;
+            reset(shard);
+        }
+        pthread_mutexattr_destroy(&attr);
+        head.magic.store(kMagic, std::memory_order_release);
+    }
+
+    // 等待创建者完成初始化(最多约 1 秒)
+    void attach(int fd) {
+        for (int wait = 0; wait < 1000; ++wait) {
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+                if (!map(fd, static_cast<size_t>(st.st_size))) return;
+                if (header().magic.load(std::memory_order_acquire) == kMagic && header().bytes == _bytes) return;
+                ::munmap(_base, _bytes);
+                _base = nullptr;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    bool map(int fd, size_t bytes) {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        _base = static_cast<char*>(p);
+        _bytes = bytes;
+        return true;
+    }
+
+    Header& header() const {return *reinterpret_cast<Header*>(_base);}
+    Shard& shardAt(uint32_t i) const {return reinterpret_cast<Shard*>(_base + header().shardOffset)[i];}
+    Shard& shardOf(uint64_t h) const {return shardAt(static_cast<uint32_t>((h >> 32) % header().shards));}
+    std::atomic<uint32_t>* buckets(Shard& shard) const {
+        return reinterpret_cast<std::atomic<uint32_t>*>(_base + shard.bucketOffset);
+    }
+    char* slotAt(Shard& shard, uint32_t slot) const {
+        return _base + shard.slotOffset + static_cast<size_t>(header().slotBytes) * slot;
+    }
+    SlotHeader& slotHeader(Shard& shard, uint32_t slot) const {return *reinterpret_cast<SlotHeader*>(slotAt(shard, slot));}
+    char* keyOf(Shard& shard, uint32_t slot) const {return slotAt(shard, slot) + sizeof(SlotHeader);}
+    char* valueOf(Shard& shard, uint32_t slot) const {return keyOf(shard, slot) + sizeof(Key);}
+    std::atomic<uint32_t>& bucketOf(Shard& shard, uint64_t h) const {return buckets(shard)[h & (header().buckets - 1)];}
+
+    void lock(Shard& shard) {
+        if (pthread_mutex_lock(&shard.mutex) == EOWNERDEAD) {
+            // 持锁进程崩溃, 分片内容不可信, 清空后继续使用
+            beginWrite(shard);
+            reset(shard);
+            endWrite(shard);
+            shard.recoveries.fetch_add(1, std::memory_order_relaxed);
+            pthread_mutex_consistent(&shard.mutex);
+        }
+    }
+    void unlock(Shard& shard) {pthread_mutex_unlock(&shard.mutex);}
+
+    // 崩溃的写入方可能把序列号留在奇数, 这里统一改为奇数再开始
+    void beginWrite(Shard& shard) {
+        shard.seq.store(shard.seq.load(std::memory_order_relaxed) | 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void endWrite(Shard& shard) {shard.seq.fetch_add(1, std::memory_order_release);}
+
+    void reset(Shard& shard) {
+        uint32_t slots = header().slots;
+        for (uint32_t b = 0; b < header().buckets; ++b) buckets(shard)[b].store(npos, std::memory_order_relaxed);
+        for (uint32_t s = 0; s < slots; ++s) {
+            SlotHeader& meta = slotHeader(shard, s);
+            meta.used = 0;
+            meta.next.store(s + 1 < slots ? s + 1 : npos, std::memory_order_relaxed);
+        }
+        shard.freeHead = 0;
+        shard.size = 0;
+        shard.hand = 0;
+    }
+
+    // 无锁读取时数据可能正被修改: 下标越界或链表过长时放弃, 由调用方按序列号重试
+    bool readSlot(Shard& shard, uint64_t h, const Key& key, char* out, uint32_t& length) const {
+        uint32_t slots = header().slots;
+        uint32_t slot = bucketOf(shard, h).load(std::memory_order_relaxed);
+        for (uint32_t steps = 0; slot < slots && steps < slots; ++steps) {
+            SlotHeader& meta = slotHeader(shard, slot);
+            if (meta.hash.load(std::memory_order_relaxed) == h && sameKey(shard, slot, key)) {
+                length = meta.length.load(std::memory_order_relaxed);
+                if (length > header().valueBytes) return false;
+                std::memcpy(out, valueOf(shard, slot), length);
+                if (!meta.referenced.load(std::memory_order_relaxed)) meta.referenced.store(1, std::memory_order_relaxed);
+                return true;
+            }
+            slot = meta.next.load(std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    bool sameKey(Shard& shard, uint32_t slot, const Key& key) const {
+        Key stored;
+        std::memcpy(&stored, keyOf(shard, slot), sizeof(Key));
+        return stored == key;
+    }
+
+    // 以下在持锁且序列号为奇数时调用
+    uint32_t find(Shard& shard, uint64_t h, const Key& key) const {
+        uint32_t slot = bucketOf(shard, h).load(std::memory_order_relaxed);
+        while (slot != npos) {
+            SlotHeader& meta = slotHeader(shard, slot);
+            if (meta.hash.load(std::memory_order_relaxed) == h && sameKey(shard, slot, key)) return slot;
+            slot = meta.next.load(std::memory_order_relaxed);
+        }
+        return npos;
+    }
+
+    uint32_t insert(Shard& shard, uint64_t h, const Key& key) {
+        uint32_t slot = shard.freeHead;
+        if (slot == npos) {
+            slot = evict(shard);
+        } else {
+            shard.freeHead = slotHeader(shard, slot).next.load(std::memory_order_relaxed);
+        }
+        SlotHeader& meta = slotHeader(shard, slot);
+        std::atomic<uint32_t>& bucket = bucketOf(shard, h);
+        meta.hash.store(h, std::memory_order_relaxed);
+        std::memcpy(keyOf(shard, slot), &key, sizeof(Key));
+        meta.used = 1;
+        meta.next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bucket.store(slot, std::memory_order_relaxed);
+        ++shard.size;
+        return slot;
+    }
+
+    // CLOCK: 跳过并清除被访问过的槽位, 取第一个未被访问的槽位
+    uint32_t evict(Shard& shard) {
+        uint32_t slots = header().slots;
+        while (true) {
+            uint32_t slot = shard.hand;
+            shard.hand = slot + 1 < slots ? slot + 1 : 0;
+            SlotHeader& meta = slotHeader(shard, slot);
+            if (meta.referenced.load(std::memory_order_relaxed)) {
+                meta.referenced.store(0, std::memory_order_relaxed);
+                continue;
+            }
+            unlinkSlot(shard, slot);
+            --shard.size;
+            return slot;
+        }
+    }
+
+    void erase(Shard& shard, uint32_t slot) {
+        unlinkSlot(shard, slot);
+        --shard.size;
+        SlotHeader& meta = slotHeader(shard, slot);
+        meta.used = 0;
+        meta.referenced.store(0, std::memory_order_relaxed);
+        meta.next.store(shard.freeHead, std::memory_order_relaxed);
+        shard.freeHead = slot;
+    }
+
+    void unlinkSlot(Shard& shard, uint32_t slot) {
+        SlotHeader& meta = slotHeader(shard, slot);
+        std::atomic<uint32_t>* link = &bucketOf(shard, meta.hash.load(std::memory_order_relaxed));
+        while (link->load(std::memory_order_relaxed) != slot) {
+            link = &slotHeader(shard, link->load(std::memory_order_relaxed)).next;
+        }
+        link->store(meta.next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+private:
+    char* _base = nullptr;
+    size_t _bytes = 0;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+
+#include "caChePolicy.h"
+#include "CacheLocking.h"
+#include "NodeStorage.h"
+
+// 分段 LRU(SLRU): 新条目进入试用段, 在试用段中再次命中后晋升到保护段;
+// 保护段超出容量时把其最久未访问的条目降回试用段尾部, 淘汰总是先从试用段头部开始.
+// 两段共用一份节点存储, 晋升与降级都只是链表之间的摘下与挂上, 不复制键值.
+// 节点所在的段记录在 Link::count 中
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>>
+class SlruCache : public caChepolicy<Key, Value>{
+public:
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex, std::hash<Key>, std::equal_to<Key>,
+                                       RebindAlloc<Alloc, std::pair<const Key, NodeIndex>>>;
+
+    // protectedRatio 为保护段占总容量的比例
+    explicit SlruCache(int capacity_, double protectedRatio = 0.8, const Alloc& alloc = Alloc())
+        : capacity(capacity_ > 0 ? capacity_ : 0)
+        , protectedCapacity(static_cast<size_t>(capacity * protectedRatio))
+        , storage_(capacity, alloc)
+        , nodeMap_(alloc)
+    {}
+    ~SlruCache() override = default;
+
+    void put(Key key, const Value& value) override{
+        if (capacity == 0) return;
+        std::lock_guard<Mutex> lock(mutex_);
+        auto it = nodeMap_.find(key);
+        if (it != nodeMap_.end()){
+            storage_.value(it->second) = value;
+            touch(it->second);
+            return;
+        }
+        if (nodeMap_.size() >= capacity) evict();
+        NodeIndex node = storage_.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
+        storage_.link(node).count = kProbation;
+        storage_.pushBack(probation_, node);
+        nodeMap_[key] = node;
+    }
+    bool get(Key key, Value& value) override{
+        std::lock_guard<Mutex> lock(mutex_);
+        auto it = nodeMap_.find(key);
+        if (it == nodeMap_.end()) return false;
+        touch(it->second);
+        value = storage_.value(it->second);
+        return true;
+    }
+    Value get(Key key) override{
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+private:
+    static constexpr uint32_t kProbation = 0;
+    static constexpr uint32_t kProtected = 1;
+
+    void touch(NodeIndex node){
+        if (storage_.link(node).count == kProtected){
+            storage_.moveToBack(protected_, node);
+            return;
+        }
+        storage_.unlink(probation_, node);
+        storage_.link(node).count = kProtected;
+        storage_.pushBack(protected_, node);
+        if (protected_.size > protectedCapacity){
+            NodeIndex demoted = protected_.head;
+            storage_.unlink(protected_, demoted);
+            storage_.link(demoted).count = kProbation;
+            storage_.pushBack(probation_, demoted);
+        }
+    }
+
+    void evict(){
+        typename Storage::List& list = probation_.empty() ? protected_ : probation_;
+        NodeIndex victim = list.head;
+        storage_.unlink(list, victim);
+        nodeMap_.erase(storage_.key(victim));
+        storage_.release(victim);
+    }
+
+private:
+    size_t capacity;
+    size_t protectedCapacity;
+    Storage storage_;
+    typename Storage::List probation_; // 头部为最久未访问
+    typename Storage::List protected_;
+    NodeMap nodeMap_;
+    Mutex mutex_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// 有界单生产者单消费者队列
+// 容量向上取整为 2 的幂; 生产者与消费者各自缓存对端下标, 减少跨核读取
+template<typename T>
+class SpscQueue{
+public:
+    explicit SpscQueue(size_t capacity)
+    : _mask(roundUp(capacity) - 1)
+    , _slots(_mask + 1)
+    {}
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 仅生产者线程调用, 队列满时返回 false
+    bool push(T item) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead > _mask){
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead > _mask) return false;
+        }
+        _slots[tail & _mask] = std::move(item);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用, 队列空时返回 false
+    bool pop(T& item) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail){
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) return false;
+        }
+        item = std::move(_slots[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+    size_t capacity() const {return _mask + 1;}
+
+private:
+    static size_t roundUp(size_t n) {
+        size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    static constexpr size_t kCacheLine = 64;
+
+    const size_t _mask;
+    std::vector<T> _slots;
+    alignas(kCacheLine) std::atomic<size_t> _head{0}; // 消费者写
+    size_t _cachedTail = 0;                             // 消费者私有
+    alignas(kCacheLine) std::atomic<size_t> _tail{0}; // 生产者写
+    size_t _cachedHead = 0;                             // 生产者私有
+};
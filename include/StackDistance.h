@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// SHARDS 抽样 + Mattson 栈距离, 一遍扫描得到 LRU 在所有容量下的命中率曲线
+// 只处理哈希落在抽样范围内的键(抽样率 rate), 抽样键空间中的栈距离 d 对应全量下的 d / rate.
+// 栈距离 = 上次访问之后访问过的不同键数量, 用树状数组统计"每个键最后一次访问的时刻".
+// 时刻数组用满后按最后访问顺序重新编号, 内存只与抽样到的不同键数量有关.
+// 模型假设读未命中之后会回填(cache-aside), 每次访问都把键移到栈顶.
+class StackDistanceProfiler{
+public:
+    explicit StackDistanceProfiler(double rate = 0.01)
+    : _rate(rate >= 1 ? 1.0 : rate)
+    , _tree(kInitialSlots + 1, 0)
+    {}
+
+    // 抽样判断可供其他模拟器共用, 同一个键在各模拟器里要么都被选中, 要么都不被选中
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+    static bool sampled(uint64_t key, double rate) {
+        return (mix(key) & (kSampleSpace - 1)) < static_cast<uint64_t>(rate * kSampleSpace);
+    }
+
+    // isRead 为 true 的访问计入命中率
+    void access(uint64_t key, bool isRead) {
+        if (isRead) ++_allReads;
+        if (!sampled(key, _rate)) return;
+        if (_now + 1 >= _tree.size()) compact();
+        uint32_t now = ++_now;
+        auto it = _last.find(key);
+        if (it == _last.end()) {
+            _last.emplace(key, now);
+        } else {
+            uint32_t prev = it->second;
+            if (isRead) {
+                size_t distance = static_cast<size_t>(prefix(now - 1) - prefix(prev));
+                if (distance >= _histogram.size()) _histogram.resize(distance + 1, 0);
+                ++_histogram[distance];
+            }
+            add(prev, -1);
+            it->second = now;
+        }
+        add(now, 1);
+        if (isRead) ++_reads;
+    }
+
+    // 容量为 capacity 时的读命中率: 还原后栈距离小于容量的读都会命中.
+    // 抽样键空间中的一格对应全量下 1 / rate 个栈距离, 容量落在格内时按比例计入该格(假设格内均匀分布),
+    // 不能四舍五入到整格: 抽样率 0.01 时容量 50 会被算成整整一格(容量 100).
+    // 抽中(或漏掉)少数极热的键会让抽样读请求数明显偏离 总读请求数 * rate, 按 SHARDS-adj 把差值计入
+    // 第一格, 分母用期望的抽样读请求数
+    double hitRate(size_t capacity) const {
+        if (_reads == 0) return 0;
+        double expected = _allReads * _rate;
+        double scaled = capacity * _rate;
+        size_t full = std::min(static_cast<size_t>(scaled), _histogram.size());
+        double hits = (expected - static_cast<double>(_reads)) * std::min(1.0, scaled);
+        for (size_t d = 0; d < full; ++d) hits += _histogram[d];
+        if (full < _histogram.size()) hits += _histogram[full] * (scaled - full);
+        return std::min(1.0, std::max(0.0, hits / expected));
+    }
+
+    // 缩小后不足 kReliableSlots 格时, 命中率依赖格内均匀的假设, 只是粗略估计
+    bool reliable(size_t capacity) const {return capacity * _rate >= kReliableSlots;}
+
+    uint64_t sampledReads() const {return _reads;}
+    size_t sampledKeys() const {return _last.size();}
+    double rate() const {return _rate;}
+
+private:
+    static constexpr uint64_t kSampleSpace = 1ull << 24;
+    static constexpr size_t kInitialSlots = 1024;
+    static constexpr double kReliableSlots = 32;
+
+    void add(size_t i, int delta) {
+        for (; i < _tree.size(); i += i & (~i + 1)) _tree[i] += delta;
+    }
+    int64_t prefix(size_t i) const {
+        int64_t sum = 0;
+        for (; i > 0; i -= i & (~i + 1)) sum += _tree[i];
+        return sum;
+    }
+
+    // 按最后访问时刻排序后重新编号为 1..K, 树状数组扩到 2K 以上
+    void compact() {
+        std::vector<std::pair<uint32_t, uint64_t>> order;
+        order.reserve(_last.size());
+        for (const auto& [key, time] : _last) order.push_back({time, key});
+        std::sort(order.begin(), order.end());
+        size_t slots = std::max(kInitialSlots, order.size() * 2);
+        _tree.assign(slots + 1, 0);
+        _now = 0;
+        for (const auto& [time, key] : order) {
+            _last[key] = ++_now;
+            add(_now, 1);
+        }
+    }
+
+private:
+    double _rate;
+    uint32_t _now = 0;
+    std::vector<int64_t> _tree;
+    std::unordered_map<uint64_t, uint32_t> _last;
+    std::vector<uint64_t> _histogram; // 下标为抽样键空间中的栈距离
+    uint64_t _reads = 0;
+    uint64_t _allReads = 0; // 包括未被抽样的读
+};
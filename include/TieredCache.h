@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "caChePolicy.h"
+#include "CacheLocking.h"
+#include "HotKeyCache.h"
+#include "LruCache.h"
+#include "RemovalListener.h"
+#include "ShmCache.h"
+
+// L2 与溢出层(L3)之间的包含关系
+enum class TierMode{
+    Inclusive, // 写入同时写 L3, L3 命中提升到 L2 后仍保留
+    Exclusive, // 只有从 L2 淘汰的条目才降级到 L3, L3 命中提升到 L2 时从 L3 删除
+};
+
+struct TierOptions{
+    size_t l1Capacity = 256;              // 每个线程的 L1 条目数
+    TierMode spillMode = TierMode::Inclusive;
+    size_t demoteBatch = 1;               // L2 淘汰通知攒够这么多条再降级到 L3
+    // 版本号的条数(取整到 2 的幂, 至少 256). 条目在 L2 中期间同一条上其他键的写入也会让它的降级被放弃,
+    // 带 L3 时取 L2 容量的 64 倍左右
+    size_t versionStripes = 4096;
+};
+
+// L1 / L2 中保存的条目: 值 + 写入时的版本号
+template<typename Value>
+struct TierEntry{
+    Value value{};
+    uint64_t version = 0;
+};
+
+// 分层缓存: 每个线程不加锁的 L1(LruCache<NullMutex>) + 共享的 L2(HashLruCache / ArcCahce 等)
+// + 可选的溢出层 L3(如以文件为后端的 ShmCache, 需要提供 put / get / remove).
+// L2 的值类型为 TierEntry<Value>, 记录写入时的版本号; 降级通过 L2 的移除监听器进行(只处理容量淘汰),
+// 所以 L2 需要提供 setRemovalListener / flushRemovals.
+// L1 是每个线程的副本, 只用 VersionTable 按写入失效(同 HotKeyCache), 命中时只读本线程的数据和一个只读的版本号.
+// L2 的容量淘汰不增加版本号, 所以 L1 不一定包含于 L2: 已从 L2 淘汰的键仍可能由 L1 返回, 独占模式下
+// 同一键也可能同时在 L1 与 L3 中. 这些副本都是最新写入的值, 写入时一起失效.
+// L2 命中提升到 L1; L3 命中提升到 L2 与 L1.
+// 同一键的写入、L3 提升与降级都在分条锁下进行: 降级时条目的版本号已不是当前版本(之后又写入过)就丢弃,
+// 提升前检查版本号, L3 中不会留下比 L2 旧的值.
+// 淘汰通知先放入待降级队列, 由 put / get 在释放分条锁之后处理(监听器在 L2 的 put 内部被调用, 此时可能
+// 已经持有分条锁). 独占模式下降级之前该条目短暂地不在任何一层, 读取会未命中; flush() 立即处理.
+template<typename Key, typename Value, typename Cache, typename Store = ShmCache<Key, Value>>
+class TieredCache : public caChepolicy<Key, Value>{
+public:
+    using Entry = TierEntry<Value>;
+
+    struct Stats{
+        uint64_t l1Hits = 0;
+        uint64_t l2Hits = 0;
+        uint64_t l3Hits = 0;
+        uint64_t misses = 0;
+        uint64_t promotions = 0; // L3 -> L2
+        uint64_t demotions = 0;  // L2 -> L3
+        uint64_t dropped = 0;    // 淘汰后又被写入而放弃的降级
+    };
+
+    TieredCache(Cache& l2, const TierOptions& options = TierOptions(), Store* l3 = nullptr)
+    : _l2(l2)
+    , _l3(l3)
+    , _options(options)
+    , _versions(std::max(options.versionStripes, kWriteLocks))
+    {
+        if (exclusive()) {
+            _l2.setRemovalListener([this](const std::vector<RemovalNotification<Key, Entry>>& batch) {
+                std::lock_guard<std::mutex> lock(_pendingMutex);
+                for (const auto& notification : batch) {
+                    if (notification.cause == RemovalCause::Capacity) _pending.push_back(notification);
+                }
+                _hasPending.store(!_pending.empty(), std::memory_order_release);
+            }, _options.demoteBatch);
+        }
+    }
+    ~TieredCache() override {
+        if (exclusive()) {
+            flush();
+            _l2.setRemovalListener(nullptr);
+        }
+    }
+
+    TieredCache(const TieredCache&) = delete;
+    TieredCache& operator=(const TieredCache&) = delete;
+
+    void put(Key key, const Value& value) override {
+        size_t hash = std::hash<Key>{}(key);
+        {
+            std::lock_guard<std::mutex> lock(writeLock(hash));
+            // 分条锁覆盖版本号的整条, 持锁期间版本号不会被其他线程改变
+            uint64_t version = _versions.load(hash) + 1;
+            if (_l3) {
+                if (exclusive()) _l3->remove(key);
+                else _l3->put(key, value);
+            }
+            _l2.put(key, Entry{value, version});
+            _versions.bump(hash);
+        }
+        demotePending();
+    }
+
+    bool get(Key key, Value& value) override {
+        size_t hash = std::hash<Key>{}(key);
+        Local& local = _locals.local(_options.l1Capacity);
+        uint64_t version = _versions.load(hash);
+        Entry entry;
+        if (local.l1.get(key, entry) && entry.version == version) {
+            value = std::move(entry.value);
+            bump(local.l1Hits);
+            return true;
+        }
+        if (_l2.get(key, entry)) {
+            bump(local.l2Hits);
+            value = entry.value;
+            local.l1.put(key, Entry{std::move(entry.value), version});
+            return true;
+        }
+        if (_l3 && promote(key, hash, version, value)) {
+            demotePending();
+            bump(local.l3Hits);
+            local.l1.put(key, Entry{value, version});
+            return true;
+        }
+        bump(local.misses);
+        return false;
+    }
+
+    Value get(Key key) override {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 立即把 L2 中缓冲的淘汰通知降级到 L3
+    void flush() {
+        if (!exclusive()) return;
+        _l2.flushRemovals();
+        demotePending();
+    }
+
+    // 各线程的计数在这里汇总
+    Stats stats() const {
+        Stats stats;
+        _locals.forEach([&](const Local& local) {
+            stats.l1Hits += local.l1Hits.load(std::memory_order_relaxed);
+            stats.l2Hits += local.l2Hits.load(std::memory_order_relaxed);
+            stats.l3Hits += local.l3Hits.load(std::memory_order_relaxed);
+            stats.misses += local.misses.load(std::memory_order_relaxed);
+        });
+        stats.promotions = _promotions.load(std::memory_order_relaxed);
+        stats.demotions = _demotions.load(std::memory_order_relaxed);
+        stats.dropped = _dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    // 须为 VersionTable 条数的约数(条数是不小于它的 2 的幂): 共用一条版本号的键一定共用一把分条锁
+    static constexpr size_t kWriteLocks = 256;
+
+    // 计数器只由所属线程写入
+    struct alignas(64) Local{
+        explicit Local(size_t capacity) : l1(static_cast<int>(capacity)) {}
+        LruCache<Key, Entry, NullMutex> l1;
+        std::atomic<uint64_t> l1Hits{0};
+        std::atomic<uint64_t> l2Hits{0};
+        std::atomic<uint64_t> l3Hits{0};
+        std::atomic<uint64_t> misses{0};
+    };
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    bool exclusive() const {return _l3 && _options.spillMode == TierMode::Exclusive;}
+
+    std::mutex& writeLock(size_t hash) {return _writeLocks[hash % kWriteLocks];}
+
+    // L3 命中: 持有该键的写入锁, 版本号未变(期间没有写入)时才写回 L2
+    bool promote(const Key& key, size_t hash, uint64_t version, Value& value) {
+        std::lock_guard<std::mutex> lock(writeLock(hash));
+        if (!_l3->get(key, value)) return false;
+        if (_versions.load(hash) != version) return true;
+        _l2.put(key, Entry{value, version});
+        if (exclusive()) _l3->remove(key);
+        _promotions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 逐条在分条锁下降级; 条目写入后该键又被写入过(版本号变化)则丢弃, 新值在 L2 中或之后自己降级
+    void demotePending() {
+        if (!_hasPending.load(std::memory_order_acquire)) return;
+        std::vector<RemovalNotification<Key, Entry>> batch;
+        {
+            std::lock_guard<std::mutex> lock(_pendingMutex);
+            batch.swap(_pending);
+            _hasPending.store(false, std::memory_order_release);
+        }
+        for (const auto& notification : batch) {
+            size_t hash = std::hash<Key>{}(notification.key);
+            std::lock_guard<std::mutex> lock(writeLock(hash));
+            if (notification.value.version != _versions.load(hash)) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            _l3->put(notification.key, notification.value.value);
+            _demotions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    Cache& _l2;
+    Store* _l3;
+    TierOptions _options;
+    VersionTable _versions;
+    std::mutex _writeLocks[kWriteLocks];
+    std::mutex _pendingMutex;
+    std::vector<RemovalNotification<Key, Entry>> _pending;
+    std::atomic<bool> _hasPending{false};
+    std::atomic<uint64_t> _promotions{0};
+    std::atomic<uint64_t> _demotions{0};
+    std::atomic<uint64_t> _dropped{0};
+    PerThread<Local> _locals;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+
+#include "caChePolicy.h"
+#include "CacheLocking.h"
+#include "FrequencySketch.h"
+#include "NodeStorage.h"
+
+// W-TinyLFU: 新条目先进入约 1% 容量的窗口 LRU, 被挤出窗口时与主 LRU 的淘汰候选比较
+// 频次估计(FrequencySketch), 估计值更大的一方留在主缓存. 一次性扫描的键频次低, 进不了主缓存
+template<typename Key, typename Value, typename Mutex = std::mutex>
+class TinyLfuCache : public caChepolicy<Key, Value>{
+public:
+    using Storage = NodeStorage<Key, Value>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex>;
+
+    explicit TinyLfuCache(int capacity_)
+        : capacity(capacity_ > 0 ? capacity_ : 0)
+        , windowCapacity(capacity / 100 > 0 ? capacity / 100 : 1)
+        , mainCapacity(capacity > windowCapacity ? capacity - windowCapacity : 0)
+        , sketch_(capacity > 0 ? capacity : 1)
+        , storage_(capacity)
+    {}
+    ~TinyLfuCache() override = default;
+
+    void put(Key key, const Value& value) override{
+        if (capacity == 0) return;
+        std::lock_guard<Mutex> lock(mutex_);
+        record(key);
+        auto it = nodeMap_.find(key);
+        if (it != nodeMap_.end()){
+            storage_.value(it->second) = value;
+            touch(it->second);
+            return;
+        }
+        NodeIndex node = storage_.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
+        storage_.link(node).count = kWindow;
+        storage_.pushBack(window_, node);
+        nodeMap_[key] = node;
+        if (window_.size > windowCapacity) admit(window_.head);
+    }
+    bool get(Key key, Value& value) override{
+        std::lock_guard<Mutex> lock(mutex_);
+        record(key);
+        auto it = nodeMap_.find(key);
+        if (it == nodeMap_.end()) return false;
+        touch(it->second);
+        value = storage_.value(it->second);
+        return true;
+    }
+    Value get(Key key) override{
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+private:
+    static constexpr uint32_t kWindow = 0;
+    static constexpr uint32_t kMain = 1;
+    static constexpr size_t kAgeStep = 64;
+
+    void record(const Key& key){
+        sketch_.increment(std::hash<Key>{}(key));
+        // 样本数达到容量的 10 倍时整体减半, 让频次反映近期的访问. 分摊到之后的操作中,
+        // 每次只处理 kAgeStep 个计数器, 大容量时不会有单次操作扫描整个 sketch
+        if (sketch_.additions() >= capacity * 10) sketch_.age(kAgeStep);
+    }
+
+    void touch(NodeIndex node){
+        storage_.moveToBack(storage_.link(node).count == kWindow ? window_ : main_, node);
+    }
+
+    // 窗口的淘汰者作为候选, 与主缓存的淘汰者比较频次
+    void admit(NodeIndex candidate){
+        storage_.unlink(window_, candidate);
+        if (main_.size < mainCapacity){
+            storage_.link(candidate).count = kMain;
+            storage_.pushBack(main_, candidate);
+            return;
+        }
+        NodeIndex victim = main_.head;
+        if (victim != Storage::npos && estimate(candidate) > estimate(victim)){
+            storage_.unlink(main_, victim);
+            evict(victim);
+            storage_.link(candidate).count = kMain;
+            storage_.pushBack(main_, candidate);
+        } else {
+            evict(candidate);
+        }
+    }
+
+    uint8_t estimate(NodeIndex node){
+        return sketch_.estimate(std::hash<Key>{}(storage_.key(node)));
+    }
+
+    void evict(NodeIndex node){
+        nodeMap_.erase(storage_.key(node));
+        storage_.release(node);
+    }
+
+private:
+    size_t capacity;
+    size_t windowCapacity;
+    size_t mainCapacity;
+    FrequencySketch sketch_;
+    Storage storage_;
+    typename Storage::List window_; // 头部为最久未访问
+    typename Storage::List main_;
+    NodeMap nodeMap_;
+    Mutex mutex_;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+
+#include "caChePolicy.h"
+#include "CacheLocking.h"
+#include "GhostTable.h"
+#include "NodeStorage.h"
+
+// 2Q(完整版): A1in 为先进先出队列, 新条目先进入这里, 在其中命中不改变位置;
+// 被挤出 A1in 的键只把指纹记入 A1out(幽灵表, 不保存值), 之后再次写入时直接进入 Am(LRU).
+// 只被访问一次的键在 A1in 中停留一段时间后离开, 不会冲刷 Am.
+// A1in 与 Am 共用一份节点存储, 节点所在的队列记录在 Link::count 中
+template<typename Key, typename Value, typename Mutex = std::mutex, typename Alloc = std::allocator<char>>
+class TwoQueueCache : public caChepolicy<Key, Value>{
+public:
+    using Storage = NodeStorage<Key, Value, Alloc>;
+    using NodeIndex = typename Storage::Index;
+    using NodeMap = std::unordered_map<Key, NodeIndex, std::hash<Key>, std::equal_to<Key>,
+                                       RebindAlloc<Alloc, std::pair<const Key, NodeIndex>>>;
+
+    // 按原论文的建议, A1in 取容量的 25%, A1out 记住容量 50% 个键
+    explicit TwoQueueCache(int capacity_, double inRatio = 0.25, double outRatio = 0.5, const Alloc& alloc = Alloc())
+        : capacity(capacity_ > 0 ? capacity_ : 0)
+        , inCapacity(static_cast<size_t>(capacity * inRatio))
+        , outCapacity(static_cast<size_t>(capacity * outRatio))
+        , storage_(capacity, alloc)
+        , nodeMap_(alloc)
+        , out_(outCapacity > 0 ? outCapacity : 1, alloc)
+    {}
+    ~TwoQueueCache() override = default;
+
+    void put(Key key, const Value& value) override{
+        if (capacity == 0) return;
+        std::lock_guard<Mutex> lock(mutex_);
+        auto it = nodeMap_.find(key);
+        if (it != nodeMap_.end()){
+            storage_.value(it->second) = value;
+            touch(it->second);
+            return;
+        }
+        if (nodeMap_.size() >= capacity) reclaim();
+        NodeIndex node = storage_.allocate(key, value, static_cast<uint32_t>(std::hash<Key>{}(key)));
+        if (out_.erase(std::hash<Key>{}(key))){
+            storage_.link(node).count = kAm;
+            storage_.pushBack(am_, node);
+        } else {
+            storage_.link(node).count = kA1in;
+            storage_.pushBack(in_, node);
+        }
+        nodeMap_[key] = node;
+    }
+    bool get(Key key, Value& value) override{
+        std::lock_guard<Mutex> lock(mutex_);
+        auto it = nodeMap_.find(key);
+        if (it == nodeMap_.end()) return false;
+        touch(it->second);
+        value = storage_.value(it->second);
+        return true;
+    }
+    Value get(Key key) override{
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+private:
+    static constexpr uint32_t kA1in = 0;
+    static constexpr uint32_t kAm = 1;
+
+    void touch(NodeIndex node){
+        if (storage_.link(node).count == kAm) storage_.moveToBack(am_, node);
+    }
+
+    // A1in 超过其份额时从 A1in 淘汰并记入 A1out, 否则淘汰 Am 中最久未访问的条目
+    void reclaim(){
+        NodeIndex victim;
+        if (in_.size > inCapacity || am_.empty()){
+            victim = in_.head;
+            storage_.unlink(in_, victim);
+            if (out_.size() >= outCapacity) out_.popOldest();
+            out_.insert(std::hash<Key>{}(storage_.key(victim)));
+        } else {
+            victim = am_.head;
+            storage_.unlink(am_, victim);
+        }
+        nodeMap_.erase(storage_.key(victim));
+        storage_.release(victim);
+    }
+
+private:
+    size_t capacity;
+    size_t inCapacity;
+    size_t outCapacity;
+    Storage storage_;
+    typename Storage::List in_; // 头部为最早进入
+    typename Storage::List am_; // 头部为最久未访问
+    NodeMap nodeMap_;
+    GhostTable<Alloc> out_;
+    Mutex mutex_;
+};
@@ -0,0 +1,455 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "caChePolicy.h"
+#include "PartitionedCache.h"
+
+// 通过 Unix 域套接字访问另一个进程中的缓存分区
+// 帧格式: [u32 负载长度][负载], 负载第一个字节为操作:
+//   'G' 批量读取: u32 个数 + 各个键; 应答按顺序为每个键写 u8 是否命中, 命中时后跟值.
+//       应答可以分成多帧, 每帧只包含完整的条目, 客户端一直读到所有键都有结果
+//   'P' 批量写入: u32 个数 + 各个键值对; 没有应答, 同一连接上后续的读取一定能看到这些写入
+//   'D' 批量删除: u32 个数 + 各个键; 没有应答. 服务端的缓存没有 remove 时忽略
+// 地址使用 Linux 的抽象命名空间(sun_path 以 '\0' 开头), 不在文件系统中留下套接字文件.
+// 测试时服务端与客户端可以在同一进程内, 与跨进程的行为相同.
+// 负载不超过 wire::kMaxFrame: 大的批量由发送方拆成多帧. 收到超过上限或个数与负载长度不符的帧视为错误,
+// 直接断开该连接. 单个条目编码后就超过上限时, 写入丢弃该条目, 读取按未命中应答.
+
+// 键和值的编码: 算术类型按本机字节序原样写入(两端在同一台机器上), std::string 写长度 + 内容
+template<typename T, typename Enable = void>
+struct WireCodec;
+
+template<typename T>
+struct WireCodec<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>{
+    static void encode(const T& value, std::string& out) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    static bool decode(const char*& p, const char* end, T& value) {
+        if (static_cast<size_t>(end - p) < sizeof(value)) return false;
+        std::memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+        return true;
+    }
+};
+
+template<>
+struct WireCodec<std::string>{
+    static void encode(const std::string& value, std::string& out) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.append(value);
+    }
+    static bool decode(const char*& p, const char* end, std::string& value) {
+        uint32_t length;
+        if (!WireCodec<uint32_t>::decode(p, end, length) || static_cast<size_t>(end - p) < length) return false;
+        value.assign(p, length);
+        p += length;
+        return true;
+    }
+};
+
+namespace wire{
+
+// 单帧负载的上限, 防止错误或恶意的长度字段让接收方分配任意大的缓冲区
+constexpr uint32_t kMaxFrame = 64u << 20;
+
+inline bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool recvAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::recv(fd, data, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// frame 的前 4 字节预留给长度, 在这里填写; 超过上限的帧不发送, 按连接错误处理
+inline bool sendFrame(int fd, std::string& frame) {
+    if (frame.size() - sizeof(uint32_t) > kMaxFrame) return false;
+    uint32_t length = static_cast<uint32_t>(frame.size() - sizeof(uint32_t));
+    std::memcpy(&frame[0], &length, sizeof(length));
+    return sendAll(fd, frame.data(), frame.size());
+}
+
+inline bool recvFrame(int fd, std::string& payload) {
+    uint32_t length;
+    if (!recvAll(fd, reinterpret_cast<char*>(&length), sizeof(length)) || length > kMaxFrame) return false;
+    payload.resize(length);
+    return length == 0 || recvAll(fd, &payload[0], length);
+}
+
+inline sockaddr_un abstractAddress(const std::string& name, socklen_t& length) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    size_t n = std::min(name.size(), sizeof(addr.sun_path) - 1);
+    std::memcpy(addr.sun_path + 1, name.data(), n);
+    length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + n);
+    return addr;
+}
+
+} // namespace wire
+
+// 服务端: 把一个已有的缓存发布到抽象套接字 name 上, 每个连接一个线程; 缓存有 remove 时支持 'D'.
+// 连接结束时服务线程自己关闭套接字, 已结束的线程在接受下一个连接时回收.
+template<typename Key, typename Value>
+class PartitionServer{
+public:
+    template<typename Cache>
+    PartitionServer(Cache& cache, const std::string& name)
+    : _cache(cache)
+    , _erase(cacheEraser<Key>(cache, 0))
+    {
+        socklen_t length;
+        sockaddr_un addr = wire::abstractAddress(name, length);
+        _listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (_listenFd < 0 || ::bind(_listenFd, reinterpret_cast<sockaddr*>(&addr), length) != 0
+            || ::listen(_listenFd, 64) != 0) {
+            if (_listenFd >= 0) ::close(_listenFd);
+            _listenFd = -1;
+            return;
+        }
+        _acceptThread = std::thread([this] {acceptLoop();});
+    }
+
+    ~PartitionServer() {stop();}
+
+    PartitionServer(const PartitionServer&) = delete;
+    PartitionServer& operator=(const PartitionServer&) = delete;
+
+    bool listening() const {return _listenFd >= 0;}
+
+    // 仍然打开的连接数
+    size_t connections() {
+        std::lock_guard<std::mutex> lock(_connectionsMutex);
+        size_t count = 0;
+        for (const auto& connection : _connections) count += connection->fd >= 0;
+        return count;
+    }
+
+    // 关闭监听与所有连接, 等待线程退出
+    void stop() {
+        if (_stopped.exchange(true)) return;
+        if (_listenFd >= 0) ::shutdown(_listenFd, SHUT_RDWR);
+        if (_acceptThread.joinable()) _acceptThread.join();
+        {
+            std::lock_guard<std::mutex> lock(_connectionsMutex);
+            for (const auto& connection : _connections) {
+                if (connection->fd >= 0) ::shutdown(connection->fd, SHUT_RDWR);
+            }
+        }
+        // 接受线程已退出, 列表不会再增加; 服务线程退出时要加锁, join 时不能持锁
+        for (const auto& connection : _connections) connection->thread.join();
+        std::lock_guard<std::mutex> lock(_connectionsMutex);
+        _connections.clear();
+        if (_listenFd >= 0) ::close(_listenFd);
+    }
+
+private:
+    // fd 只在持锁时关闭并置为 -1, stop() 不会 shutdown 一个已被复用的描述符
+    struct Connection{
+        int fd;
+        std::thread thread;
+    };
+
+    void acceptLoop() {
+        while (!_stopped.load()) {
+            int fd = ::accept4(_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(_connectionsMutex);
+            if (_stopped.load()) {
+                ::close(fd);
+                return;
+            }
+            reap();
+            _connections.emplace_back(new Connection{fd, std::thread()});
+            Connection* connection = _connections.back().get();
+            connection->thread = std::thread([this, connection] {
+                serve(connection->fd);
+                std::lock_guard<std::mutex> lock(_connectionsMutex);
+                ::close(connection->fd);
+                connection->fd = -1;
+            });
+        }
+    }
+
+    // 持锁调用: 回收已关闭连接的线程(线程已放开锁, 只差返回)
+    void reap() {
+        auto finished = std::partition(_connections.begin(), _connections.end(),
+                                       [](const std::unique_ptr<Connection>& connection) {return connection->fd >= 0;});
+        for (auto it = finished; it != _connections.end(); ++it) (*it)->thread.join();
+        _connections.erase(finished, _connections.end());
+    }
+
+    // 每个条目至少占一个字节, 个数超过剩余负载长度的帧一定不合法, 在分配之前拒绝
+    static bool validCount(uint32_t count, const char* p, const char* end) {
+        return count <= static_cast<size_t>(end - p);
+    }
+
+    void serve(int fd) {
+        std::string request, response, entry;
+        std::vector<Key> keys;
+        Value value{};
+        while (wire::recvFrame(fd, request)) {
+            const char* p = request.data();
+            const char* end = p + request.size();
+            uint32_t count;
+            if (p == end) return;
+            char op = *p++;
+            if (!WireCodec<uint32_t>::decode(p, end, count) || !validCount(count, p, end)) return;
+            if (op == 'P') {
+                Key key{};
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!WireCodec<Key>::decode(p, end, key) || !WireCodec<Value>::decode(p, end, value)) return;
+                    _cache.put(key, value);
+                }
+            } else if (op == 'D') {
+                Key key{};
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!WireCodec<Key>::decode(p, end, key)) return;
+                    if (_erase) _erase(key);
+                }
+            } else if (op == 'G') {
+                keys.resize(count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!WireCodec<Key>::decode(p, end, keys[i])) return;
+                }
+                response.assign(sizeof(uint32_t), '\0');
+                for (const Key& key : keys) {
+                    entry.assign(1, '\0');
+                    if (_cache.get(key, value)) {
+                        entry[0] = 1;
+                        WireCodec<Value>::encode(value, entry);
+                        if (entry.size() > wire::kMaxFrame) entry.assign(1, '\0');
+                    }
+                    // 放不下时先发出已有的条目, 应答分成多帧
+                    if (response.size() - sizeof(uint32_t) + entry.size() > wire::kMaxFrame) {
+                        if (!wire::sendFrame(fd, response)) return;
+                        response.assign(sizeof(uint32_t), '\0');
+                    }
+                    response += entry;
+                }
+                if (!keys.empty() && !wire::sendFrame(fd, response)) return;
+            } else {
+                return;
+            }
+        }
+    }
+
+private:
+    caChepolicy<Key, Value>& _cache;
+    std::function<void(const Key&)> _erase;
+    int _listenFd = -1;
+    std::atomic<bool> _stopped{false};
+    std::thread _acceptThread;
+    std::mutex _connectionsMutex;
+    std::vector<std::unique_ptr<Connection>> _connections;
+};
+
+// 客户端: 作为 PartitionedCache 的一个分区. 一条连接, 请求在连接上串行进行;
+// 连接出错(收发失败或应答不合法)后断开, 这一次的读取未命中、写入被丢弃(缓存语义下可以接受),
+// 下一次调用时重新连接. errors() 为出错断开的次数, dropped() 为编码后超过帧上限而丢弃的条目数
+template<typename Key, typename Value>
+class UnixSocketPartition : public CachePartition<Key, Value>{
+public:
+    explicit UnixSocketPartition(const std::string& name)
+    : _name(name)
+    {
+        connect();
+    }
+    ~UnixSocketPartition() override {
+        if (_fd >= 0) ::close(_fd);
+    }
+
+    UnixSocketPartition(const UnixSocketPartition&) = delete;
+    UnixSocketPartition& operator=(const UnixSocketPartition&) = delete;
+
+    bool connected() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _fd >= 0;
+    }
+    uint64_t errors() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _errors;
+    }
+    uint64_t dropped() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _dropped;
+    }
+
+    void putBatch(const std::vector<std::pair<Key, Value>>& entries) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (entries.empty() || !connect()) return;
+        sendItems('P', entries.size(), [&](size_t i) {
+            WireCodec<Key>::encode(entries[i].first, _item);
+            WireCodec<Value>::encode(entries[i].second, _item);
+        });
+    }
+
+    void eraseBatch(const std::vector<Key>& keys) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (keys.empty() || !connect()) return;
+        sendItems('D', keys.size(), [&](size_t i) {WireCodec<Key>::encode(keys[i], _item);});
+    }
+
+    void getBatch(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<char>& found) override {
+        values.resize(keys.size());
+        found.assign(keys.size(), 0);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (keys.empty() || !connect()) return;
+        // 每帧请求发出后先读完它的应答再发下一帧, 两端不会同时阻塞在发送上
+        beginFrame('G');
+        for (size_t i = 0; i < keys.size(); ++i) {
+            _item.clear();
+            WireCodec<Key>::encode(keys[i], _item);
+            if (!fits(_item)) {
+                ++_dropped;
+                continue;
+            }
+            if (full(_item)) {
+                if (!sendRequest() || !readReplies(values, found)) return;
+                beginFrame('G');
+            }
+            appendItem();
+            _frameKeys.push_back(i);
+        }
+        if (_frameCount > 0 && sendRequest()) readReplies(values, found);
+    }
+
+private:
+    static constexpr size_t kHeader = sizeof(uint32_t) + 1 + sizeof(uint32_t); // 长度 + 操作 + 个数
+
+    bool connect() {
+        if (_fd >= 0) return true;
+        socklen_t length;
+        sockaddr_un addr = wire::abstractAddress(_name, length);
+        _fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (_fd >= 0 && ::connect(_fd, reinterpret_cast<sockaddr*>(&addr), length) != 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+        return _fd >= 0;
+    }
+
+    // 只在收发失败或应答不合法时调用
+    void disconnect() {
+        ::close(_fd);
+        _fd = -1;
+        ++_errors;
+    }
+
+    // 没有应答的请求('P' / 'D'): 逐个编码条目, 放不下时先发出当前帧
+    template<typename Encode>
+    void sendItems(char op, size_t count, const Encode& encode) {
+        beginFrame(op);
+        for (size_t i = 0; i < count; ++i) {
+            _item.clear();
+            encode(i);
+            if (!fits(_item)) {
+                ++_dropped;
+                continue;
+            }
+            if (full(_item)) {
+                if (!sendRequest()) return;
+                beginFrame(op);
+            }
+            appendItem();
+        }
+        if (_frameCount > 0) sendRequest();
+    }
+
+    void beginFrame(char op) {
+        _frame.assign(sizeof(uint32_t), '\0');
+        _frame.push_back(op);
+        WireCodec<uint32_t>::encode(0, _frame);
+        _frameCount = 0;
+        _frameKeys.clear();
+    }
+    // 单独一个条目能否放进一帧
+    static bool fits(const std::string& item) {return kHeader - sizeof(uint32_t) + item.size() <= wire::kMaxFrame;}
+    bool full(const std::string& item) const {
+        return _frameCount > 0 && _frame.size() - sizeof(uint32_t) + item.size() > wire::kMaxFrame;
+    }
+    void appendItem() {
+        _frame += _item;
+        ++_frameCount;
+    }
+
+    bool sendRequest() {
+        std::memcpy(&_frame[sizeof(uint32_t) + 1], &_frameCount, sizeof(_frameCount));
+        if (wire::sendFrame(_fd, _frame)) return true;
+        disconnect();
+        return false;
+    }
+
+    // 读取当前请求帧的应答(可能分成多帧), 按 _frameKeys 填回 values / found
+    bool readReplies(std::vector<Value>& values, std::vector<char>& found) {
+        size_t next = 0;
+        while (next < _frameKeys.size()) {
+            if (!wire::recvFrame(_fd, _reply) || _reply.empty()) {
+                disconnect();
+                return false;
+            }
+            const char* p = _reply.data();
+            const char* end = p + _reply.size();
+            while (p != end && next < _frameKeys.size()) {
+                size_t i = _frameKeys[next++];
+                found[i] = *p++;
+                if (found[i] && !WireCodec<Value>::decode(p, end, values[i])) {
+                    found[i] = 0;
+                    disconnect();
+                    return false;
+                }
+            }
+            if (p != end) {
+                disconnect();
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::string _name;
+    int _fd = -1;
+    std::mutex _mutex;
+    uint64_t _errors = 0;
+    uint64_t _dropped = 0;
+    std::string _frame;               // 当前请求帧
+    std::string _reply;               // 应答帧
+    std::string _item;                // 正在编码的条目
+    uint32_t _frameCount = 0;         // 当前请求帧中的条目数
+    std::vector<size_t> _frameKeys;   // 当前 'G' 请求帧中各个键在 keys 中的下标
+};
@@ -0,0 +1,241 @@
+#pragma once
+
+// 基准测试用的访问分布生成器
+// 每个生成器都是无状态的函数对象: key = gen(rng, index), index 为操作在序列中的位置.
+// 与位置相关的分布(顺序扫描、latest、阶段切换)只依赖 index, 因此序列可以切块并行生成,
+// 结果与线程数无关, 只由种子决定.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// xoshiro256**, 比 std::mt19937 快数倍, 状态只有 32 字节
+class WorkloadRng {
+public:
+    explicit WorkloadRng(uint64_t seed) {
+        for (auto& word : state) word = splitmix(seed);
+    }
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+    // [0, 1)
+    double uniform() {return (next() >> 11) * 0x1.0p-53;}
+    // [0, n)
+    uint64_t below(uint64_t n) {return static_cast<uint64_t>(uniform() * n);}
+
+    static uint64_t splitmix(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+    uint64_t state[4];
+};
+
+// Zipf 分布, 返回 [0, n) 的排名, 0 最热. 拒绝-反演采样(Hörmann & Derflinger), 每次采样 O(1), 不需要预计算表
+class ZipfGenerator {
+public:
+    ZipfGenerator(uint64_t n, double exponent)
+    : _n(static_cast<double>(n))
+    , _s(exponent)
+    , _hIntegralX1(hIntegral(1.5) - 1)
+    , _hIntegralN(hIntegral(_n + 0.5))
+    , _threshold(2 - hIntegralInverse(hIntegral(2.5) - h(2)))
+    {}
+
+    uint64_t operator()(WorkloadRng& rng, uint64_t) const {
+        while (true) {
+            double u = _hIntegralN + rng.uniform() * (_hIntegralX1 - _hIntegralN);
+            double x = hIntegralInverse(u);
+            double k = std::floor(x + 0.5);
+            if (k < 1) k = 1;
+            else if (k > _n) k = _n;
+            if (k - x <= _threshold || u >= hIntegral(k + 0.5) - h(k))
+                return static_cast<uint64_t>(k) - 1;
+        }
+    }
+
+private:
+    double h(double x) const {return std::exp(-_s * std::log(x));}
+    double hIntegral(double x) const {
+        double logX = std::log(x);
+        return helper2((1 - _s) * logX) * logX;
+    }
+    double hIntegralInverse(double x) const {
+        double t = x * (1 - _s);
+        if (t < -1) t = -1;
+        return std::exp(helper1(t) * x);
+    }
+    // log1p(x) / x 与 expm1(x) / x, 在 0 附近用泰勒展开
+    static double helper1(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+    }
+    static double helper2(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+    }
+
+private:
+    double _n;
+    double _s;
+    double _hIntegralX1;
+    double _hIntegralN;
+    double _threshold;
+};
+
+// 打散的 Zipf: 热门排名映射到整个键空间的随机位置, 热键不再集中在小编号
+class ScrambledZipfGenerator {
+public:
+    ScrambledZipfGenerator(uint64_t n, double exponent) : _zipf(n, exponent), _n(n) {}
+    uint64_t operator()(WorkloadRng& rng, uint64_t index) const {
+        uint64_t rank = _zipf(rng, index);
+        return WorkloadRng::splitmix(rank) % _n;
+    }
+private:
+    ZipfGenerator _zipf;
+    uint64_t _n;
+};
+
+// 热点: hotOpFraction 的访问落在前 hotFraction 的键上, 两部分内部均匀
+class HotspotGenerator {
+public:
+    HotspotGenerator(uint64_t n, double hotFraction, double hotOpFraction)
+    : _n(n)
+    , _hot(std::max<uint64_t>(1, static_cast<uint64_t>(n * hotFraction)))
+    , _hotOpFraction(hotOpFraction)
+    {}
+    uint64_t operator()(WorkloadRng& rng, uint64_t) const {
+        if (_hot >= _n || rng.uniform() < _hotOpFraction) return rng.below(_hot);
+        return _hot + rng.below(_n - _hot);
+    }
+private:
+    uint64_t _n;
+    uint64_t _hot;
+    double _hotOpFraction;
+};
+
+// latest: 每 advanceEvery 次操作产生一个新键, 越新的键越热(与最新键的距离服从 Zipf)
+class LatestGenerator {
+public:
+    LatestGenerator(uint64_t window, double exponent, uint64_t advanceEvery)
+    : _zipf(window, exponent), _advanceEvery(advanceEvery > 0 ? advanceEvery : 1) {}
+    uint64_t operator()(WorkloadRng& rng, uint64_t index) const {
+        uint64_t newest = index / _advanceEvery;
+        uint64_t distance = _zipf(rng, index);
+        return distance > newest ? 0 : newest - distance;
+    }
+private:
+    ZipfGenerator _zipf;
+    uint64_t _advanceEvery;
+};
+
+// 顺序扫描 [start, start + n)
+class ScanGenerator {
+public:
+    explicit ScanGenerator(uint64_t n, uint64_t start = 0) : _n(n > 0 ? n : 1), _start(start) {}
+    uint64_t operator()(WorkloadRng&, uint64_t index) const {return _start + index % _n;}
+private:
+    uint64_t _n;
+    uint64_t _start;
+};
+
+// 多个循环按权重混合, 每个循环占用独立的键区间, 在各自区间内按 index 顺序推进
+class LoopMixGenerator {
+public:
+    // loops: {循环长度, 权重}
+    explicit LoopMixGenerator(const std::vector<std::pair<uint64_t, double>>& loops) {
+        double total = 0;
+        for (const auto& loop : loops) total += loop.second;
+        double cumulative = 0;
+        uint64_t base = 0;
+        for (const auto& loop : loops) {
+            cumulative += loop.second / total;
+            _loops.push_back({std::max<uint64_t>(1, loop.first), base, cumulative});
+            base += loop.first;
+        }
+    }
+    uint64_t operator()(WorkloadRng& rng, uint64_t index) const {
+        double u = rng.uniform();
+        for (const auto& loop : _loops) {
+            if (u < loop.cumulative) return loop.base + index % loop.size;
+        }
+        const Loop& last = _loops.back();
+        return last.base + index % last.size;
+    }
+private:
+    struct Loop {
+        uint64_t size;
+        uint64_t base;
+        double cumulative;
+    };
+    std::vector<Loop> _loops;
+};
+
+// 阶段切换: 依次使用各阶段的生成器, 全部阶段结束后从头循环. 没有任何阶段(或总长度为 0)时总是生成键 0
+class PhaseSchedule {
+public:
+    using Generator = std::function<uint64_t(WorkloadRng&, uint64_t)>;
+
+    PhaseSchedule& add(Generator generator, uint64_t length) {
+        _total += length;
+        _phases.push_back({std::move(generator), _total});
+        return *this;
+    }
+    uint64_t operator()(WorkloadRng& rng, uint64_t index) const {
+        if (_total == 0) return 0;
+        uint64_t position = index % _total;
+        auto it = std::upper_bound(_phases.begin(), _phases.end(), position,
+                                   [](uint64_t pos, const Phase& phase) {return pos < phase.end;});
+        return it->generator(rng, index);
+    }
+private:
+    struct Phase {
+        Generator generator;
+        uint64_t end;
+    };
+    std::vector<Phase> _phases;
+    uint64_t _total = 0;
+};
+
+// 预先生成 {isPut, key} 操作序列. 按固定大小切块, 每块使用由种子和块号派生的随机数, 各线程领取不同的块
+template<typename Key = int, typename Generator>
+std::vector<std::pair<bool, Key>> generateOps(const Generator& generator, size_t count, double putRatio,
+                                              uint64_t seed, unsigned threads = 0) {
+    const size_t kChunk = 1 << 16;
+    std::vector<std::pair<bool, Key>> ops(count);
+    size_t chunks = (count + kChunk - 1) / kChunk;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, chunks)));
+
+    auto work = [&](unsigned worker) {
+        for (size_t chunk = worker; chunk < chunks; chunk += threads) {
+            uint64_t chunkSeed = seed ^ (chunk * 0x9e3779b97f4a7c15ULL);
+            WorkloadRng rng(chunkSeed);
+            size_t end = std::min(count, (chunk + 1) * kChunk);
+            for (size_t i = chunk * kChunk; i < end; ++i) {
+                bool isPut = rng.uniform() < putRatio;
+                ops[i] = {isPut, static_cast<Key>(generator(rng, i))};
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work, t);
+    work(0);
+    for (auto& worker : workers) worker.join();
+    return ops;
+}
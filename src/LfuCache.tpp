@@ -1,103 +1,150 @@
 
 #include <LfuCache.h>
+#include <algorithm>
 #include <climits>
+#include <functional>
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::getInternal(NodePtr node,Value& value){
-    value = node->_value;
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::getInternal(NodeIndex node,Value& value){
+    value = _storage.value(node);
     removeFromFreqList(node);
-    int oldFreq = node->freq;
-    node->freq = std::min(node->freq + 1, _maxAverageNum * 2);
+    int oldFreq = freqOf(node);
+    setFreq(node, std::min(oldFreq + 1, _maxFreq));
     addToFreqList(node);
-    if (_freqToFreqList.find(oldFreq) == _freqToFreqList.end() && node->freq == _minFreq + 1)
+    if (_freqToFreqList.find(oldFreq) == _freqToFreqList.end() && freqOf(node) == _minFreq + 1)
         _minFreq++;
-    addFreqNum();
+    // 频次到达上限后不再计入总数, 保证总数等于各节点频次之和
+    addFreqNum(freqOf(node) - oldFreq);
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::putInternal(Key _key,const Value& _value){
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::putInternal(Key _key,const Value& _value){
     if (_capacity == _nodeMap.size()) kickOut();
-    NodePtr tempPtr = std::make_shared<Node>(_key, _value);
+    NodeIndex tempPtr = _storage.allocate(_key, _value, static_cast<uint32_t>(std::hash<Key>{}(_key)));
     _nodeMap[_key] = tempPtr;
     addToFreqList(tempPtr);
-    addFreqNum();
+    addFreqNum(1);
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::kickOut(){
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::kickOut(){
     updateMinFreq();
-    NodePtr tempNode = _freqToFreqList[_minFreq]->getFirstNode();
+    NodeIndex tempNode = _freqToFreqList[_minFreq]->getFirstNode();
+    if (_notifier.enabled())
+        _notifier.record(_storage.key(tempNode), _storage.value(tempNode), RemovalCause::Capacity);
     removeFromFreqList(tempNode);
-    _nodeMap.erase(tempNode->_key);
-    decreaseFreqNum(tempNode->freq);
+    _nodeMap.erase(_storage.key(tempNode));
+    decreaseFreqNum(freqOf(tempNode));
+    _storage.release(tempNode);
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::removeFromFreqList(NodePtr node){
-    if (!node) return;
-    int freq = node->freq;
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::removeFromFreqList(NodeIndex node){
+    if (node == Storage::npos) return;
+    int freq = freqOf(node);
     _freqToFreqList[freq]->removeNode(node);
     if (_freqToFreqList[freq]->isEmpty()) {
         _freqToFreqList.erase(freq);
     }
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::addToFreqList(NodePtr node){
-    if (!node) return;
-    int freq = node->freq;
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::addToFreqList(NodeIndex node){
+    if (node == Storage::npos) return;
+    int freq = freqOf(node);
     if (_freqToFreqList.find(freq) == _freqToFreqList.end()){
-        _freqToFreqList[freq] = std::make_shared<FreqList<Key, Value>>(freq);
+        _freqToFreqList[freq] = std::allocate_shared<FreqList<Key, Value, Alloc>>(_alloc, freq, _storage);
     }
     _freqToFreqList[freq]->addNode(node);
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::addFreqNum(){
-    _curTotalNum++;
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::addFreqNum(int num){
+    _curTotalNum += num;
 
     if (_nodeMap.empty())
         _curAverageNum = 0;
     else
-        _curAverageNum = _curTotalNum / _nodeMap.size();
+        _curAverageNum = _curTotalNum / static_cast<long long>(_nodeMap.size());
     
-    if (_curAverageNum > _maxAverageNum)
-        handleOverMaxAverageNum();
+    // 超过上限时只记录待老化的频次桶, 节点分摊到之后的操作(或 maintain())中逐个减半
+    if (_curAverageNum > _maxAverageNum && !_agingPending)
+        startAging();
+    if (_agingPending && !_backgroundAging)
+        ageSlice(kAgingStep);
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::decreaseFreqNum(int num){
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::decreaseFreqNum(int num){
     _curTotalNum -= num;
     if (_nodeMap.empty())
         _curAverageNum = 0;
     else
-        _curAverageNum  = _curTotalNum / _nodeMap.size();
+        _curAverageNum = _curTotalNum / static_cast<long long>(_nodeMap.size());
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::handleOverMaxAverageNum(){
-    if (_nodeMap.empty()) return;
-    for (auto it = _nodeMap.begin(); it != _nodeMap.end(); ++it){
-        if (!it->second) continue;
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::updateMinFreq(){
+    _minFreq = INT_MAX;
+    for (const auto& [freq, list] : _freqToFreqList) {
+        if (list && !list->isEmpty()) {
+            _minFreq = std::min(_minFreq, freq);
+        }
+    }
+    if (_minFreq == INT_MAX) _minFreq = 1;
+}
 
-        NodePtr tempPtr = it->second;
-        if (tempPtr->freq > _maxAverageNum / 2) {
-            removeFromFreqList(tempPtr);
-            tempPtr->freq /= 2;
-            if (tempPtr->freq < 1) tempPtr->freq = 1;
-            addToFreqList(tempPtr);
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+size_t LfuCache<Key, Value, Mutex, Alloc>::maintain(size_t budget){
+    size_t done = 0;
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        size_t lowWatermark = static_cast<size_t>(_capacity * _lowWatermark);
+        while (done < budget && !_nodeMap.empty() && _nodeMap.size() > lowWatermark){
+            kickOut();
+            ++done;
         }
+        if (_agingPending && done < budget)
+            done += ageSlice(budget - done);
     }
-    updateMinFreq();
+    _notifier.dispatch();
+    return done;
 }
 
-template<typename Key, typename Value>
-void LfuCache<Key, Value>::updateMinFreq(){
-    _minFreq = INT_MAX;
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+void LfuCache<Key, Value, Mutex, Alloc>::startAging(){
+    _agingFreqs.clear();
     for (const auto& [freq, list] : _freqToFreqList) {
-        if (list && !list->isEmpty()) {
-            _minFreq = std::min(_minFreq, freq);
+        if (freq > 1 && freq > _maxAverageNum / 2) _agingFreqs.push_back(freq);
+    }
+    // 从低频桶开始处理(back 为最小值): 同一次 ageSlice 内减半后的节点落入已处理过的桶, 不会再被处理.
+    // 老化分多次进行时, 两次之间被访问的节点频次会变化: 已减半的节点可能升入尚未处理的桶而再被减半,
+    // 尚未处理的节点也可能升入不在 _agingFreqs 中的桶而这一轮不减半. 只是近似的老化, 不影响正确性
+    std::sort(_agingFreqs.begin(), _agingFreqs.end(), std::greater<int>());
+    _agingPending = true;
+}
+
+template<typename Key, typename Value, typename Mutex, typename Alloc>
+size_t LfuCache<Key, Value, Mutex, Alloc>::ageSlice(size_t budget){
+    size_t done = 0;
+    while (done < budget && !_agingFreqs.empty()){
+        int freq = _agingFreqs.back();
+        auto it = _freqToFreqList.find(freq);
+        if (it == _freqToFreqList.end()){
+            _agingFreqs.pop_back();
+            continue;
         }
+        NodeIndex node = it->second->getFirstNode();
+        removeFromFreqList(node);
+        setFreq(node, std::max(freq / 2, 1));
+        _curTotalNum -= freq - freqOf(node);
+        addToFreqList(node);
+        ++done;
     }
-    if (_minFreq == INT_MAX) _minFreq = 1;
+    if (_agingFreqs.empty()){
+        _agingPending = false;
+        updateMinFreq();
+        _curAverageNum = _nodeMap.empty() ? 0 : _curTotalNum / static_cast<long long>(_nodeMap.size());
+    }
+    return done;
 }
\ No newline at end of file
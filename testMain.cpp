@@ -5,6 +5,24 @@
 #include <iomanip>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #include "caChePolicy.h"
 #include "LruCache.h"
@@ -13,6 +31,30 @@
 #include "LfuCache.h"
 #include "HashLfuCache.h"
 #include "ArcCache.h"
+#include "PolicyCache.h"
+#include "PerCoreCache.h"
+#include "ConcurrentLfuCache.h"
+#include "MaintenanceExecutor.h"
+#include "RemovalListener.h"
+#include "GhostTable.h"
+#include "TinyLfuCache.h"
+#include "AdaptiveCache.h"
+#include "Workload.h"
+#include "CacheAllocator.h"
+#include "PmrCache.h"
+#include "NumaShardedCache.h"
+#include "GlobalHashLruCache.h"
+#include "SampledCache.h"
+#include "SlruCache.h"
+#include "TwoQueueCache.h"
+#include "NegativeCache.h"
+#include "CompressedCache.h"
+#include "PartitionedCache.h"
+#include "UnixSocketPartition.h"
+#include "ShmCache.h"
+#include "HotKeyCache.h"
+#include "TieredCache.h"
+#include <unordered_set>
 
 class Timer {
 public:
@@ -124,6 +166,76 @@ void testHotDataAccess() {
     printResults("热点数据访问测试", CAPACITY, get_operations, hits);
 }
 
+// 固定随机种子, 每次运行的操作序列相同, 结果可以直接比较
+const unsigned kSeed = 20240601;
+
+// 所有策略共用的只读操作序列; value 在生成序列时预先构造, 回放时只拷贝
+struct Operation {
+    bool isPut;
+    int key;
+    int value; // values 中的下标
+};
+
+struct ReplayResult {
+    int hits = 0;
+    int gets = 0;
+    double ms = 0;    // 墙钟时间
+    double cpuMs = 0; // 线程 CPU 时间, 核数少于策略数时墙钟时间包含等待调度的时间
+};
+
+double threadCpuMs() {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#else
+    return 0;
+#endif
+}
+
+// 每个策略一个线程, 同时回放同一份操作序列, 分别计时
+std::vector<ReplayResult> replayInParallel(const std::vector<caChepolicy<int, std::string>*>& caches,
+                                           const std::vector<Operation>& operations,
+                                           const std::vector<std::string>& values) {
+    std::vector<ReplayResult> results(caches.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < caches.size(); ++i) {
+        threads.emplace_back([&, i] {
+            caChepolicy<int, std::string>& cache = *caches[i];
+            ReplayResult& result = results[i];
+            std::string value;
+            double cpuStart = threadCpuMs();
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& op : operations) {
+                if (op.isPut) {
+                    cache.put(op.key, values[op.value]);
+                } else {
+                    ++result.gets;
+                    if (cache.get(op.key, value)) ++result.hits;
+                }
+            }
+            result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            result.cpuMs = threadCpuMs() - cpuStart;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return results;
+}
+
+void printResults(const std::string& testName, int capacity, const std::vector<ReplayResult>& results) {
+    std::vector<int> get_operations, hits;
+    for (const auto& result : results) {
+        get_operations.push_back(result.gets);
+        hits.push_back(result.hits);
+    }
+    printResults(testName, capacity, get_operations, hits);
+    std::cout << "耗时(ms):";
+    for (const auto& result : results) std::cout << " " << std::fixed << std::setprecision(2) << result.ms;
+    std::cout << std::endl << "CPU(ms): ";
+    for (const auto& result : results) std::cout << " " << std::fixed << std::setprecision(2) << result.cpuMs;
+    std::cout << std::endl;
+}
+
 void testHotDataAccess(int) {
     std::cout << "\n=== 测试场景1: 热点数据访问测试(Same Data) ===" << std::endl;
 
@@ -140,20 +252,16 @@ void testHotDataAccess(int) {
     HashLfuCache<int, std::string>hashlfuk(CAPACITY, 2, 30);
     ArcCahce<int, std::string>arc(CAPACITY, 5);
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(kSeed);
 
-    // 所有策略共用一份操作序列
-    struct Operation {
-        bool isPut;
-        int key;
-    };
     std::vector<Operation> operations;
-    operations.reserve(OPERATIONS);
+    std::vector<std::string> values;
+    operations.reserve(HOT_KEYS + OPERATIONS);
 
     // 预热阶段：将所有热点数据写入缓存
     for (int key = 0; key < HOT_KEYS; ++key) {
-        operations.push_back({true, key});
+        operations.push_back({true, key, static_cast<int>(values.size())});
+        values.push_back("val" + std::to_string(key) + "_" + std::to_string(key % 100));
     }
 
     // 生成 OPERATIONS 个读写操作
@@ -162,32 +270,13 @@ void testHotDataAccess(int) {
         int key = (gen() % 100 < 70)
                     ? (gen() % HOT_KEYS)               // 热点
                     : (HOT_KEYS + gen() % COLD_KEYS);  // 冷点
-        operations.push_back({isPut, key});
+        operations.push_back({isPut, key, isPut ? static_cast<int>(values.size()) : -1});
+        if (isPut) values.push_back("val" + std::to_string(key) + "_" + std::to_string((HOT_KEYS + i) % 100));
     }
 
     // 所有缓存策略
-    std::array<caChepolicy<int, std::string>*, 7> caches = {&lru, &lruk, &hashLru, &lfu, &lfuk, &hashlfuk, &arc};
-    std::vector<std::string> names = {"lru", "lruk", "hashLru", "lfu", "lfuk", "hashlfuk", "arc"};
-    std::vector<int> hits(caches.size(), 0);
-    std::vector<int> get_operations(caches.size(), 0);
-
-    for (int i = 0; i < caches.size(); ++i) {
-        for (int op_index = 0; op_index < operations.size(); ++op_index) {
-            const auto& op = operations[op_index];
-
-            if (op.isPut) {
-                std::string value = "val" + std::to_string(op.key) + "_" + std::to_string(op_index % 100);
-                caches[i]->put(op.key, value);
-            } else {
-                std::string result;
-                get_operations[i]++;
-                if (caches[i]->get(op.key, result)) {
-                    hits[i]++;
-                }
-            }
-        }
-    }
-    printResults("热点数据访问测试", CAPACITY, get_operations, hits);
+    std::vector<caChepolicy<int, std::string>*> caches = {&lru, &lruk, &hashLru, &lfu, &lfuk, &hashlfuk, &arc};
+    printResults("热点数据访问测试", CAPACITY, replayInParallel(caches, operations, values));
 }
 
 void testLoopPattern(int) {
@@ -205,22 +294,19 @@ void testLoopPattern(int) {
     HashLfuCache<int, std::string>hashlfuk(CAPACITY, 2, 30);
     ArcCahce<int, std::string>arc(CAPACITY, 5);
 
-    std::array<caChepolicy<int, std::string>*, 7> caches = {&lru, &lruk, &hashLru, &lfu, &lfuk, &hashlfuk, &arc};
-    std::vector<std::string> names = {"lru", "lruk", "hashLru", "lfu", "lfuk", "hashlfuk", "arc"};
-    std::vector<int> hits(caches.size(), 0);
-    std::vector<int> get_operations(caches.size(), 0);
+    std::vector<caChepolicy<int, std::string>*> caches = {&lru, &lruk, &hashLru, &lfu, &lfuk, &hashlfuk, &arc};
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(kSeed);
 
-    // ✅ 操作序列结构（仅记录是否为 put 和 key）
-    struct Operation {
-        bool isPut;
-        int key;
-        int opIndex;  // 可用于生成 value
-    };
     std::vector<Operation> operations;
-    operations.reserve(OPERATIONS);
+    std::vector<std::string> values;
+    operations.reserve(LOOP_SIZE / 5 + OPERATIONS);
+
+    // 预热：加载20%初始数据
+    for (int key = 0; key < LOOP_SIZE / 5; ++key) {
+        operations.push_back({true, key, static_cast<int>(values.size())});
+        values.push_back("init" + std::to_string(key));
+    }
 
     // ✅ 提前生成操作序列，确保一致性
     int current_pos = 0;
@@ -237,33 +323,12 @@ void testLoopPattern(int) {
             key = LOOP_SIZE + (gen() % LOOP_SIZE);
         }
 
-        operations.push_back({isPut, key, op});
-    }
-
-    // ✅ 各缓存策略运行相同操作序列
-    for (int i = 0; i < caches.size(); ++i) {
-        // 预热：加载20%初始数据
-        for (int key = 0; key < LOOP_SIZE / 5; ++key) {
-            std::string value = "init" + std::to_string(key);
-            caches[i]->put(key, value);
-        }
-
-        for (const auto& op : operations) {
-            if (op.isPut) {
-                // 即时生成写入 value，避免存储
-                std::string value = "val_" + std::to_string(op.key) + "_" + std::to_string(op.opIndex % 100);
-                caches[i]->put(op.key, value);
-            } else {
-                std::string result;
-                get_operations[i]++;
-                if (caches[i]->get(op.key, result)) {
-                    hits[i]++;
-                }
-            }
-        }
+        operations.push_back({isPut, key, isPut ? static_cast<int>(values.size()) : -1});
+        if (isPut) values.push_back("val_" + std::to_string(key) + "_" + std::to_string(op % 100));
     }
 
-    printResults("循环扫描测试", CAPACITY, get_operations, hits);
+    // ✅ 各缓存策略并行运行相同操作序列
+    printResults("循环扫描测试", CAPACITY, replayInParallel(caches, operations, values));
 }
 
 void testWorkloadShift(int) {
@@ -281,23 +346,21 @@ void testWorkloadShift(int) {
     HashLfuCache<int, std::string>hashlfuk(CAPACITY, 2, 30);
     ArcCahce<int, std::string>arc(CAPACITY, 5);
 
-    std::array<caChepolicy<int, std::string>*, 7> caches = {&lru, &lruk, &hashLru, &lfu, &lfuk, &hashlfuk, &arc};
-    std::vector<std::string> names = {"lru", "lruk", "hashLru", "lfu", "lfuk", "hashlfuk", "arc"};
-    std::vector<int> hits(caches.size(), 0);
-    std::vector<int> get_operations(caches.size(), 0);
+    std::vector<caChepolicy<int, std::string>*> caches = {&lru, &lruk, &hashLru, &lfu, &lfuk, &hashlfuk, &arc};
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(kSeed);
 
-    // 保存操作序列：isPut + key（不保存 value）
-    struct Operation {
-        bool isPut;
-        int key;
-        int phase;
-    };
     std::vector<Operation> operations;
+    std::vector<std::string> values;
 
-    // 生成统一操作序列
+    // 预热
+    for (int key = 0; key < 30; ++key) {
+        operations.push_back({true, key, static_cast<int>(values.size())});
+        values.push_back("init" + std::to_string(key));
+    }
+
+    // 生成统一操作序列; 每个阶段的 value 只与 key 有关, 按 (阶段, key) 复用
+    std::vector<std::vector<int>> interned(5);
     for (int op = 0; op < OPERATIONS; ++op) {
         int phase = op / PHASE_LENGTH;
         int putProbability;
@@ -333,41 +396,1735 @@ void testWorkloadShift(int) {
             }
         }
 
-        operations.push_back({isPut, key, phase});
+        int value = -1;
+        if (isPut) {
+            std::vector<int>& slots = interned[phase];
+            if (slots.size() <= static_cast<size_t>(key)) slots.resize(key + 1, -1);
+            if (slots[key] < 0) {
+                slots[key] = static_cast<int>(values.size());
+                values.push_back("value" + std::to_string(key) + "_p" + std::to_string(phase));
+            }
+            value = slots[key];
+        }
+        operations.push_back({isPut, key, value});
     }
 
-    // 对每种策略执行相同操作序列
-    for (int i = 0; i < caches.size(); ++i) {
-        // 预热
-        for (int key = 0; key < 30; ++key) {
-            std::string value = "init" + std::to_string(key);
-            caches[i]->put(key, value);
+    // 对每种策略并行执行相同操作序列
+    printResults("工作负载剧烈变化测试", CAPACITY, replayInParallel(caches, operations, values));
+}
+
+// 编译期组合策略 与 虚函数接口 的对比: 同一份操作序列, 比较命中率与耗时
+template<typename CacheType>
+void runPolicyCase(const std::string& name, CacheType& cache,
+                   const std::vector<std::pair<bool, int>>& operations) {
+    int hits = 0, gets = 0;
+    std::string result;
+    Timer timer;
+    for (const auto& op : operations) {
+        if (op.first) {
+            cache.put(op.second, "value" + std::to_string(op.second));
+        } else {
+            ++gets;
+            if (cache.get(op.second, result)) ++hits;
+        }
+    }
+    double ms = timer.elapsed();
+    std::cout << std::left << std::setw(28) << name << std::right
+              << " - 命中率: " << std::fixed << std::setprecision(2) << 100.0 * hits / gets << "% "
+              << "(" << hits << "/" << gets << ")  耗时: " << ms << "ms" << std::endl;
+}
+
+void testPolicyCache(int) {
+    std::cout << "\n=== 测试场景4：策略组合缓存 vs 虚函数缓存 ===" << std::endl;
+
+    const int CAPACITY = 100;
+    const int OPERATIONS = 200000;
+    const int HOT_KEYS = 100;
+    const int COLD_KEYS = 5000;
+
+    std::mt19937 gen(42);
+    std::vector<std::pair<bool, int>> operations;
+    operations.reserve(OPERATIONS);
+    for (int op = 0; op < OPERATIONS; ++op) {
+        bool isPut = (gen() % 100 < 30);
+        int key = (gen() % 100 < 70) ? (gen() % HOT_KEYS) : (HOT_KEYS + gen() % COLD_KEYS);
+        operations.push_back({isPut, key});
+    }
+
+    LruCache<int, std::string> lru(CAPACITY);
+    PolicyCacheAdapter<Cache<int, std::string>> adapted(CAPACITY);
+    Cache<int, std::string> plainLru(CAPACITY);
+    Cache<int, std::string, LfuEviction> plainLfu(CAPACITY);
+    Cache<int, std::string, LruEviction, HashIndex, StripedLocking<2>> stripedLru(CAPACITY);
+    Cache<int, std::string, ClockEviction, HashIndex, RWLocking, CountingStats> rwClock(CAPACITY);
+
+    std::cout << "缓存大小: " << CAPACITY << std::endl;
+    runPolicyCase<caChepolicy<int, std::string>>("LruCache(virtual)", lru, operations);
+    runPolicyCase<caChepolicy<int, std::string>>("Cache<LRU>(adapter)", adapted, operations);
+    runPolicyCase("Cache<LRU>", plainLru, operations);
+    runPolicyCase("Cache<LFU>", plainLfu, operations);
+    runPolicyCase("Cache<LRU,Striped<2>>", stripedLru, operations);
+    runPolicyCase("Cache<CLOCK,RW,Stats>", rwClock, operations);
+    std::cout << "CLOCK 统计 - 淘汰次数: " << rwClock.stats().evictions()
+              << " 命中率: " << 100.0 * rwClock.stats().hitRate() << "%" << std::endl;
+}
+
+
+// 每核独占缓存(SPSC 转发) vs HashLruCache, 总容量相同
+void testPerCoreCache(int) {
+    std::cout << "\n=== 测试场景5：每核独占缓存 vs HashLruCache ===" << std::endl;
+
+    const int THREADS = 4;
+    const int CAPACITY = 400;
+    const int OPERATIONS = 50000;   // 每个线程的操作次数
+    const int HOT_KEYS = 400;
+    const int COLD_KEYS = 10000;
+
+    std::vector<std::vector<std::pair<bool, int>>> operations(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        std::mt19937 gen(1000 + t);
+        operations[t].reserve(OPERATIONS);
+        for (int op = 0; op < OPERATIONS; ++op) {
+            bool isPut = (gen() % 100 < 30);
+            int key = (gen() % 100 < 70) ? (gen() % HOT_KEYS) : (HOT_KEYS + gen() % COLD_KEYS);
+            operations[t].push_back({isPut, key});
+        }
+    }
+    auto report = [&](const std::string& name, const std::vector<int>& hits,
+                      const std::vector<int>& gets, double ms) {
+        int totalHits = 0, totalGets = 0;
+        for (int t = 0; t < THREADS; ++t) {
+            totalHits += hits[t];
+            totalGets += gets[t];
+        }
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << " - 命中率: " << std::fixed << std::setprecision(2) << 100.0 * totalHits / totalGets << "% "
+                  << "(" << totalHits << "/" << totalGets << ")  耗时: " << ms << "ms" << std::endl;
+    };
+    std::cout << "线程数: " << THREADS << " 总缓存大小: " << CAPACITY << std::endl;
+
+    {
+        HashLruCache<int, std::string> hashLru(CAPACITY, THREADS);
+        std::vector<int> hits(THREADS, 0), gets(THREADS, 0);
+        Timer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&, t] {
+                std::string result;
+                for (const auto& op : operations[t]) {
+                    if (op.first) {
+                        hashLru.put(op.second, "value" + std::to_string(op.second));
+                    } else {
+                        ++gets[t];
+                        if (hashLru.get(op.second, result)) ++hits[t];
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        report("HashLruCache", hits, gets, timer.elapsed());
+    }
+    {
+        PerCoreCache<int, std::string> perCore(CAPACITY, THREADS);
+        std::vector<int> hits(THREADS, 0), gets(THREADS, 0);
+        std::atomic<int> finished{0};
+        Timer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&, t] {
+                std::string result;
+                for (const auto& op : operations[t]) {
+                    if (op.first) {
+                        perCore.put(t, op.second, "value" + std::to_string(op.second));
+                    } else {
+                        ++gets[t];
+                        if (perCore.get(t, op.second, result)) ++hits[t];
+                    }
+                }
+                // 其他核可能仍在等待本核的回复
+                finished.fetch_add(1);
+                while (finished.load() < THREADS) {
+                    if (perCore.poll(t) == 0) std::this_thread::yield();
+                }
+                perCore.poll(t);
+            });
+        }
+        for (auto& th : threads) th.join();
+        report("PerCoreCache(SPSC)", hits, gets, timer.elapsed());
+    }
+
+    // 单线程下加锁与不加锁的开销对比
+    LruCache<int, std::string> locked(CAPACITY);
+    LruCache<int, std::string, NullMutex> unlocked(CAPACITY);
+    runPolicyCase<caChepolicy<int, std::string>>("LruCache<std::mutex>", locked, operations[0]);
+    runPolicyCase<caChepolicy<int, std::string>>("LruCache<NullMutex>", unlocked, operations[0]);
+}
+
+// 多线程回放: 每个线程回放自己的操作序列, 汇总命中率与总耗时
+void runThreadedCase(const std::string& name, caChepolicy<int, std::string>& cache,
+                     const std::vector<std::vector<std::pair<bool, int>>>& operations) {
+    size_t threadNum = operations.size();
+    std::vector<int> hits(threadNum, 0), gets(threadNum, 0);
+    Timer timer;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadNum; ++t) {
+        threads.emplace_back([&, t] {
+            std::string result;
+            for (const auto& op : operations[t]) {
+                if (op.first) {
+                    cache.put(op.second, "value" + std::to_string(op.second));
+                } else {
+                    ++gets[t];
+                    if (cache.get(op.second, result)) ++hits[t];
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double ms = timer.elapsed();
+    int totalHits = 0, totalGets = 0;
+    for (size_t t = 0; t < threadNum; ++t) {
+        totalHits += hits[t];
+        totalGets += gets[t];
+    }
+    std::cout << std::left << std::setw(28) << name << std::right
+              << " - 命中率: " << std::fixed << std::setprecision(2) << 100.0 * totalHits / totalGets << "% "
+              << "(" << totalHits << "/" << totalGets << ")  耗时: " << ms << "ms" << std::endl;
+}
+
+// 读多写少场景下 互斥锁 LFU 与 读写锁 + 近似计数 LFU 的对比
+void testConcurrentLfu(int) {
+    std::cout << "\n=== 测试场景6：读写锁 LFU vs 互斥锁 LFU ===" << std::endl;
+
+    const int THREADS = 4;
+    const int CAPACITY = 200;
+    const int OPERATIONS = 50000;   // 每个线程的操作次数
+    const int HOT_KEYS = 150;
+    const int COLD_KEYS = 10000;
+
+    std::vector<std::vector<std::pair<bool, int>>> operations(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        std::mt19937 gen(2000 + t);
+        for (int op = 0; op < OPERATIONS; ++op) {
+            bool isPut = (gen() % 100 < 10);   // 10% 写操作
+            int key = (gen() % 100 < 80) ? (gen() % HOT_KEYS) : (HOT_KEYS + gen() % COLD_KEYS);
+            operations[t].push_back({isPut, key});
+        }
+    }
+
+    LfuCache<int, std::string> lfu(CAPACITY, 30);
+    ConcurrentLfuCache<int, std::string> concurrentLfu(CAPACITY, 30);
+    HashLfuCache<int, std::string> hashLfu(CAPACITY, THREADS, 30);
+    HashLfuCache<int, std::string, ConcurrentLfuCache<int, std::string>> hashConcurrentLfu(CAPACITY, THREADS, 30);
+
+    std::cout << "线程数: " << THREADS << " 缓存大小: " << CAPACITY << std::endl;
+    runThreadedCase("LfuCache", lfu, operations);
+    runThreadedCase("ConcurrentLfuCache", concurrentLfu, operations);
+    runThreadedCase("HashLfuCache<LfuCache>", hashLfu, operations);
+    runThreadedCase("HashLfuCache<Concurrent>", hashConcurrentLfu, operations);
+}
+
+// 输出单次操作延迟的分位数(微秒)
+void printLatency(const std::string& name, std::vector<double> latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << " - p50: " << percentile(0.50) << "us  p99: " << percentile(0.99)
+              << "us  p999: " << percentile(0.999) << "us  max: " << latencies.back() << "us" << std::endl;
+}
+
+template<typename CacheType>
+std::vector<double> measureLatency(CacheType& cache, const std::vector<std::pair<bool, int>>& operations) {
+    std::vector<double> latencies;
+    latencies.reserve(operations.size());
+    std::string result;
+    for (const auto& op : operations) {
+        std::string value = "value" + std::to_string(op.second);
+        auto begin = std::chrono::steady_clock::now();
+        if (op.first) {
+            cache.put(op.second, value);
+        } else {
+            cache.get(op.second, result);
+        }
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+    return latencies;
+}
+
+// 淘汰与老化放在请求线程 vs 交给后台维护线程, 对比单次操作的尾延迟
+void testMaintenance(int) {
+    std::cout << "\n=== 测试场景7：后台维护线程 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int OPERATIONS = 30000;
+    const int HOT_KEYS = 1000;
+    const int COLD_KEYS = 20000;
+
+    std::mt19937 gen(3000);
+    std::vector<std::pair<bool, int>> operations;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        bool isPut = (gen() % 100 < 30);
+        int key = (gen() % 100 < 70) ? (gen() % HOT_KEYS) : (HOT_KEYS + gen() % COLD_KEYS);
+        operations.push_back({isPut, key});
+    }
+    // 维护线程与请求线程共用 CPU 时后台模式没有收益, 见 MaintenanceExecutor.h
+    std::cout << "缓存大小: " << CAPACITY << " 操作次数: " << OPERATIONS
+              << " CPU 数: " << std::thread::hardware_concurrency() << std::endl;
+
+    {
+        LfuCache<int, std::string> lfu(CAPACITY, 10);
+        printLatency("LfuCache(inline aging)", measureLatency(lfu, operations));
+    }
+    {
+        LfuCache<int, std::string> lfu(CAPACITY, 10);
+        lfu.setBackgroundAging(true);
+        lfu.setLowWatermark(0.95);
+        MaintenanceExecutor executor;
+        executor.registerCache(lfu);
+        executor.start();
+        printLatency("LfuCache(background)", measureLatency(lfu, operations));
+        executor.stop();
+    }
+    {
+        ArcCahce<int, std::string> arc(CAPACITY, 5);
+        printLatency("ArcCache(inline)", measureLatency(arc, operations));
+    }
+    {
+        ArcCahce<int, std::string> arc(CAPACITY, 5);
+        arc.setLowWatermark(0.95);
+        MaintenanceExecutor executor;
+        executor.registerCache(arc);
+        executor.start();
+        printLatency("ArcCache(background)", measureLatency(arc, operations));
+        executor.stop();
+    }
+}
+
+// 移除监听器: 统计各原因的通知数量, 并验证慢监听器不会拖慢持锁时间
+void testRemovalListener(int) {
+    std::cout << "\n=== 测试场景8：移除监听器(批量投递) ===" << std::endl;
+
+    const int CAPACITY = 100;
+    const int OPERATIONS = 50000;
+    const int KEYS = 1000;
+
+    std::mt19937 gen(4000);
+    std::vector<std::pair<bool, int>> operations;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        operations.push_back({gen() % 100 < 50, static_cast<int>(gen() % KEYS)});
+    }
+
+    struct CauseCounter {
+        std::mutex mutex;
+        std::array<int, 4> counts{};
+        int batches = 0;
+        void operator()(const std::vector<RemovalNotification<int, std::string>>& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++batches;
+            for (const auto& n : batch) ++counts[static_cast<int>(n.cause)];
+        }
+        void print(const std::string& name) {
+            std::cout << std::left << std::setw(16) << name << std::right
+                      << " - capacity: " << counts[0] << " explicit: " << counts[2]
+                      << " replaced: " << counts[3] << " 批次: " << batches << std::endl;
+        }
+    };
+    auto replay = [&](caChepolicy<int, std::string>& cache) {
+        std::string result;
+        for (const auto& op : operations) {
+            if (op.first) cache.put(op.second, "value" + std::to_string(op.second));
+            else cache.get(op.second, result);
+        }
+    };
+
+    CauseCounter lruCounter, lfuCounter, arcCounter;
+    LruCache<int, std::string> lru(CAPACITY);
+    LfuCache<int, std::string> lfu(CAPACITY, 30);
+    ArcCahce<int, std::string> arc(CAPACITY, 5);
+    lru.setRemovalListener(std::ref(lruCounter));
+    lfu.setRemovalListener(std::ref(lfuCounter));
+    arc.setRemovalListener(std::ref(arcCounter));
+    replay(lru);
+    for (int key = 0; key < KEYS; key += 10) lru.remove(key);
+    replay(lfu);
+    replay(arc);
+    lru.flushRemovals();
+    lfu.flushRemovals();
+    arc.flushRemovals();
+    lruCounter.print("LruCache");
+    lfuCounter.print("LfuCache");
+    arcCounter.print("ArcCache");
+
+    // 慢监听器(每批 2ms): 批量投递在锁外进行, 对比无监听器时的耗时
+    LruCache<int, std::string> plain(CAPACITY);
+    LruCache<int, std::string> slow(CAPACITY);
+    slow.setRemovalListener([](const std::vector<RemovalNotification<int, std::string>>&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }, 256);
+    Timer plainTimer;
+    replay(plain);
+    double plainMs = plainTimer.elapsed();
+    Timer slowTimer;
+    replay(slow);
+    slow.flushRemovals();
+    double slowMs = slowTimer.elapsed();
+    std::cout << "无监听器耗时: " << plainMs << "ms  慢监听器(批量 256)耗时: " << slowMs << "ms" << std::endl;
+}
+
+// 硬件缓存未命中计数器(perf_event_open), 不可用时(非 Linux / 容器内无权限)返回 -1
+class PerfCounter {
+public:
+    PerfCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~PerfCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    long long stop() {
+#ifdef __linux__
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+private:
+    int fd = -1;
+};
+
+// 冷热分离节点布局: LruCache(链表指针与键值分开存放) vs Cache<LRU>(整节点), 值为 128 字节
+void testNodeLayout(int) {
+    std::cout << "\n=== 测试场景9：冷热分离节点布局(缓存未命中) ===" << std::endl;
+
+    using Payload = std::array<char, 128>;
+    const int CAPACITY = 50000;
+    const int OPERATIONS = 1000000;
+    const int KEYS = 200000;
+
+    std::mt19937 gen(9000);
+    std::vector<std::pair<bool, int>> operations;
+    operations.reserve(OPERATIONS);
+    for (int op = 0; op < OPERATIONS; ++op) {
+        operations.push_back({gen() % 100 < 40, static_cast<int>(gen() % KEYS)});
+    }
+
+    auto run = [&](const std::string& name, auto& cache) {
+        Payload payload{};
+        Payload result{};
+        int hits = 0;
+        PerfCounter counter;
+        counter.start();
+        Timer timer;
+        for (const auto& op : operations) {
+            if (op.first) {
+                payload[0] = static_cast<char>(op.second);
+                cache.put(op.second, payload);
+            } else if (cache.get(op.second, result)) {
+                ++hits;
+            }
+        }
+        double ms = timer.elapsed();
+        long long misses = counter.stop();
+        std::cout << std::left << std::setw(20) << name << std::right
+                  << " - 命中: " << hits << "  耗时: " << ms << "ms  缓存未命中/操作: ";
+        if (misses < 0) std::cout << "unavailable" << std::endl;
+        else std::cout << std::fixed << std::setprecision(2) << static_cast<double>(misses) / OPERATIONS << std::endl;
+    };
+
+    LruCache<int, Payload> split(CAPACITY);
+    Cache<int, Payload> whole(CAPACITY);
+    std::cout << "缓存大小: " << CAPACITY << " 值大小: " << sizeof(Payload) << "B" << std::endl;
+    run("LruCache(冷热分离)", split);
+    run("Cache<LRU>(整节点)", whole);
+}
+
+// 幽灵链表查询: 指纹表(SIMD 比较 tag) vs 哈希集合, 大部分查询的键不在幽灵链表中
+void testGhostProbe(int) {
+    std::cout << "\n=== 测试场景10：幽灵链表指纹探测 ===" << std::endl;
+
+    const int GHOSTS = 100000;
+    const int LOOKUPS = 2000000;
+
+    GhostTable<> table(GHOSTS);
+    std::unordered_set<int> set;
+    for (int key = 0; key < GHOSTS; ++key) {
+        table.insert(std::hash<int>{}(key * 2));
+        set.insert(key * 2);
+    }
+
+    std::mt19937 gen(10000);
+    std::vector<int> keys(LOOKUPS);
+    for (int& key : keys) {
+        // 约 10% 命中
+        key = (gen() % 10 == 0) ? static_cast<int>(gen() % GHOSTS) * 2 : GHOSTS * 2 + static_cast<int>(gen() % (GHOSTS * 10));
+    }
+
+    auto run = [&](const std::string& name, auto&& contains) {
+        int found = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int key : keys) found += contains(key);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << " - 命中: " << found << "  每次查询: " << std::fixed << std::setprecision(2)
+                  << ns / LOOKUPS << "ns" << std::endl;
+    };
+    run("GhostTable", [&](int key) {return table.contains(std::hash<int>{}(key));});
+    run("std::unordered_set", [&](int key) {return set.count(key) > 0;});
+}
+
+// 当前进程的常驻内存(KB), 读取失败时返回 -1
+long long residentKB() {
+#ifdef __linux__
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) return -1;
+    long long pages = 0, resident = 0;
+    int n = std::fscanf(file, "%lld %lld", &pages, &resident);
+    std::fclose(file);
+    if (n != 2) return -1;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+// 64KB 大值下的常驻内存: 幽灵链表只保留键指纹, ARC 的内存应与容量同量级
+void testGhostMemory(int) {
+    std::cout << "\n=== 测试场景11：大值下的常驻内存(幽灵链表不保留值) ===" << std::endl;
+
+    const int CAPACITY = 256;
+    const int VALUE_SIZE = 64 * 1024;
+    const int OPERATIONS = 20000;
+    const int KEYS = CAPACITY * 8;
+
+    std::mt19937 gen(11000);
+    std::vector<std::pair<bool, int>> operations;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        operations.push_back({gen() % 100 < 50, static_cast<int>(gen() % KEYS)});
+    }
+
+    auto run = [&](const std::string& name, caChepolicy<int, std::string>& cache) {
+        long long before = residentKB();
+        std::string result;
+        for (const auto& op : operations) {
+            if (op.first) cache.put(op.second, std::string(VALUE_SIZE, static_cast<char>('a' + op.second % 26)));
+            else cache.get(op.second, result);
+        }
+        long long after = residentKB();
+        std::cout << std::left << std::setw(12) << name << std::right << " - 常驻内存增长: ";
+        if (before < 0 || after < 0) std::cout << "unavailable" << std::endl;
+        else std::cout << (after - before) / 1024 << "MB" << std::endl;
+    };
+
+#ifdef __GLIBC__
+    // 让 64KB 的值走 mmap, 释放后立即归还系统, 常驻内存即为存活的值
+    mallopt(M_MMAP_THRESHOLD, VALUE_SIZE / 2);
+    malloc_trim(0);
+#endif
+    std::cout << "缓存大小: " << CAPACITY << " 值大小: 64KB 名义容量: "
+              << static_cast<long long>(CAPACITY) * VALUE_SIZE / (1024 * 1024) << "MB" << std::endl;
+    {
+        LruCache<int, std::string> lru(CAPACITY);
+        run("LRU", lru);
+    }
+    {
+        ArcCahce<int, std::string> arc(CAPACITY, 2);
+        run("ARC", arc);
+    }
+}
+
+// 自适应策略: 三个阶段依次为 稳定热点 / 循环扫描夹杂热点 / 滑动工作集, 每个阶段的最优策略不同
+void testAdaptivePolicy(int) {
+    std::cout << "\n=== 测试场景12：自适应策略选择 ===" << std::endl;
+
+    const int CAPACITY = 500;
+    const int PHASE_OPERATIONS = 100000;
+
+    std::mt19937 gen(12000);
+    std::vector<std::pair<bool, int>> operations;
+    // 阶段一: 少量热点键反复访问, 大量冷键偶尔出现
+    for (int op = 0; op < PHASE_OPERATIONS; ++op) {
+        int key = (gen() % 100 < 60) ? static_cast<int>(gen() % 300) : 1000 + static_cast<int>(gen() % 20000);
+        operations.push_back({gen() % 100 < 20, key});
+    }
+    // 阶段二: 循环扫描略大于容量的范围, 同时访问一组热点键
+    for (int op = 0; op < PHASE_OPERATIONS; ++op) {
+        int key = (gen() % 100 < 30) ? static_cast<int>(gen() % 200) : 50000 + op % (CAPACITY * 2);
+        operations.push_back({gen() % 100 < 20, key});
+    }
+    // 阶段三: 工作集缓慢平移, 最近访问的键最可能再次访问
+    for (int op = 0; op < PHASE_OPERATIONS; ++op) {
+        int key = 100000 + op / 20 + static_cast<int>(gen() % (CAPACITY / 2));
+        operations.push_back({gen() % 100 < 30, key});
+    }
+
+    LruCache<int, std::string> lru(CAPACITY);
+    LfuCache<int, std::string> lfu(CAPACITY);
+    ArcCahce<int, std::string> arc(CAPACITY, 2);
+    TinyLfuCache<int, std::string> tinyLfu(CAPACITY);
+    AdaptiveCache<int, std::string> adaptive(CAPACITY);
+
+    std::cout << "缓存大小: " << CAPACITY << " 操作次数: " << operations.size() << std::endl;
+    runPolicyCase<caChepolicy<int, std::string>>("LRU", lru, operations);
+    runPolicyCase<caChepolicy<int, std::string>>("LFU", lfu, operations);
+    runPolicyCase<caChepolicy<int, std::string>>("ARC", arc, operations);
+    runPolicyCase<caChepolicy<int, std::string>>("TinyLFU", tinyLfu, operations);
+    runPolicyCase<caChepolicy<int, std::string>>("Adaptive", adaptive, operations);
+    std::cout << "Adaptive 最终策略: " << policyName(adaptive.policy())
+              << " 切换次数: " << adaptive.switches() << std::endl;
+}
+
+// 分布生成器: 并行生成速度, 以及各策略在不同分布下的命中率
+void testWorkloadLibrary(int) {
+    std::cout << "\n=== 测试场景13：访问分布生成器 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int KEYS = 100000;
+    const size_t OPERATIONS = 2000000;
+
+    PhaseSchedule phases;
+    phases.add(ZipfGenerator(KEYS, 0.99), OPERATIONS / 4)
+          .add(ScanGenerator(CAPACITY * 3, KEYS), OPERATIONS / 4)
+          .add(HotspotGenerator(KEYS, 0.01, 0.9), OPERATIONS / 2);
+
+    auto run = [&](const std::string& name, const auto& generator) {
+        auto start = std::chrono::steady_clock::now();
+        auto operations = generateOps(generator, OPERATIONS, 0.2, kSeed);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        LruCache<int, std::string> lru(CAPACITY);
+        ArcCahce<int, std::string> arc(CAPACITY, 2);
+        TinyLfuCache<int, std::string> tinyLfu(CAPACITY);
+        std::array<caChepolicy<int, std::string>*, 3> caches = {&lru, &arc, &tinyLfu};
+        std::cout << std::left << std::setw(16) << name << std::right << " - 生成: "
+                  << std::fixed << std::setprecision(1) << OPERATIONS / ms / 1000 << "M ops/s  命中率:";
+        const std::string value = "value";
+        for (auto* cache : caches) {
+            int hits = 0, gets = 0;
+            std::string result;
+            for (const auto& op : operations) {
+                if (op.first) cache->put(op.second, value);
+                else if (++gets, cache->get(op.second, result)) ++hits;
+            }
+            std::cout << " " << std::setprecision(2) << 100.0 * hits / gets << "%";
+        }
+        std::cout << std::endl;
+    };
+
+    std::cout << "缓存大小: " << CAPACITY << " 键空间: " << KEYS << " 操作次数: " << OPERATIONS
+              << " (命中率依次为 LRU / ARC / TinyLFU)" << std::endl;
+    run("Zipf(0.99)", ZipfGenerator(KEYS, 0.99));
+    run("ScrambledZipf", ScrambledZipfGenerator(KEYS, 0.99));
+    run("Hotspot(1%/90%)", HotspotGenerator(KEYS, 0.01, 0.9));
+    run("Latest", LatestGenerator(KEYS, 0.99, 10));
+    run("Scan", ScanGenerator(CAPACITY * 2));
+    run("LoopMix", LoopMixGenerator({{CAPACITY / 2, 0.5}, {CAPACITY * 4, 0.5}}));
+    run("Phases", phases);
+}
+
+// 每个条目的元数据开销: 各缓存的全部内部容器都使用计数分配器, 值为 int 以排除负载本身
+// 1000 万条目耗时较长, 设置环境变量 CACHE_BENCH_LARGE 后才运行
+void testMemoryFootprint(int) {
+    std::cout << "\n=== 测试场景14：每条目内存开销(计数分配器) ===" << std::endl;
+
+    using Alloc = CountingAllocator<char>;
+    std::vector<int> sizes = {1000, 1000000};
+    if (std::getenv("CACHE_BENCH_LARGE")) sizes.push_back(10000000);
+
+    auto run = [](const std::string& name, int entries, AllocationStats& stats, caChepolicy<int, int>& cache) {
+        // 每个键写两次(LRU-K 第二次才进入主缓存), 键数为容量的两倍, 最后读一遍后一半
+        size_t ops = 0;
+        for (int key = 0; key < entries * 2; ++key) {
+            cache.put(key, key);
+            cache.put(key, key);
+            ops += 2;
+        }
+        int value;
+        for (int key = entries; key < entries * 2; ++key, ++ops) cache.get(key, value);
+        std::cout << std::left << std::setw(10) << name << std::right << std::setw(10) << entries
+                  << " - 字节/条目: " << std::fixed << std::setprecision(1)
+                  << static_cast<double>(stats.liveBytes.load()) / entries
+                  << "  峰值字节/条目: " << static_cast<double>(stats.peakBytes.load()) / entries
+                  << "  分配次数/操作: " << std::setprecision(3)
+                  << static_cast<double>(stats.allocations.load()) / ops << std::endl;
+    };
+
+    for (int entries : sizes) {
+        {
+            AllocationStats stats;
+            LruCache<int, int, std::mutex, Alloc> cache(entries, Alloc(&stats));
+            run("LRU", entries, stats, cache);
+        }
+        {
+            AllocationStats stats;
+            LruKCache<int, int, Alloc> cache(entries, entries, 2, Alloc(&stats));
+            run("LRU-K", entries, stats, cache);
+        }
+        {
+            AllocationStats stats;
+            HashLruCache<int, int, Alloc> cache(entries, 4, Alloc(&stats));
+            run("HASHLRU", entries, stats, cache);
+        }
+        {
+            AllocationStats stats;
+            LfuCache<int, int, std::mutex, Alloc> cache(entries, 30, Alloc(&stats));
+            run("LFU", entries, stats, cache);
+        }
+        {
+            AllocationStats stats;
+            HashLfuCache<int, int, LfuCache<int, int, std::mutex, Alloc>> cache(entries, 4, 30, Alloc(&stats));
+            run("HASHLFU", entries, stats, cache);
+        }
+        {
+            AllocationStats stats;
+            ArcCahce<int, int, std::mutex, Alloc> cache(entries, 2, Alloc(&stats));
+            run("ARC", entries, stats, cache);
+        }
+    }
+}
+
+// std::pmr 内存资源: 请求级的小缓存反复创建、填充、销毁, 比较默认分配器与 pmr 资源
+void testPmrResources(int) {
+    std::cout << "\n=== 测试场景15：std::pmr 内存资源 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int ROUNDS = 200;
+    const int OPERATIONS = 5000;
+
+    std::mt19937 gen(kSeed);
+    std::vector<std::pair<bool, int>> operations;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        operations.push_back({gen() % 100 < 40, static_cast<int>(gen() % (CAPACITY * 3))});
+    }
+
+    auto replay = [&](auto& cache, auto& value) {
+        int hits = 0;
+        auto result = value;
+        for (const auto& op : operations) {
+            if (op.first) cache.put(op.second, value);
+            else if (cache.get(op.second, result)) ++hits;
+        }
+        return hits;
+    };
+    auto report = [&](const std::string& name, double ms, long long hits) {
+        std::cout << std::left << std::setw(28) << name << std::right << " - 耗时: " << std::fixed
+                  << std::setprecision(2) << ms << "ms  命中: " << hits << std::endl;
+    };
+    const char* text = "a value that does not fit in the small string buffer";
+
+    {
+        long long hits = 0;
+        std::string value = text;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round) {
+            LruCache<int, std::string, NullMutex> cache(CAPACITY);
+            hits += replay(cache, value);
+        }
+        report("std::allocator", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), hits);
+    }
+    {
+        // 一块缓冲区反复使用: 每轮结束后 release() 一次性回收缓存的全部内存
+        long long hits = 0;
+        std::vector<char> buffer(8 << 20);
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round) {
+            {
+                pmr::LruCache<int, std::pmr::string, NullMutex> cache(CAPACITY, &arena);
+                std::pmr::string value(text, &arena);
+                hits += replay(cache, value);
+            }
+            arena.release();
+        }
+        report("pmr monotonic(请求级)", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), hits);
+    }
+    {
+        long long hits = 0;
+        std::pmr::unsynchronized_pool_resource pool;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round) {
+            pmr::LruCache<int, std::pmr::string, NullMutex> cache(CAPACITY, &pool);
+            std::pmr::string value(text, &pool);
+            hits += replay(cache, value);
+        }
+        report("pmr unsynchronized_pool", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), hits);
+    }
+    {
+        // 其余策略同样可以放进独立的资源
+        std::pmr::unsynchronized_pool_resource pool;
+        pmr::LfuCache<int, std::pmr::string> lfu(CAPACITY, 30, &pool);
+        pmr::ArcCache<int, std::pmr::string> arc(CAPACITY, 2, &pool);
+        pmr::LruKCache<int, std::pmr::string> lruk(CAPACITY, CAPACITY, 2, &pool);
+        pmr::HashLruCache<int, std::pmr::string> hashLru(CAPACITY, 4, &pool);
+        pmr::HashLfuCache<int, std::pmr::string> hashLfu(CAPACITY, 4, 30, &pool);
+        std::pmr::string value(text, &pool);
+        std::cout << "pmr LFU/ARC/LRU-K/HashLRU/HashLFU 命中: " << replay(lfu, value) << "/" << replay(arc, value)
+                  << "/" << replay(lruk, value) << "/" << replay(hashLru, value) << "/" << replay(hashLfu, value) << std::endl;
+    }
+}
+
+// NUMA 感知分片: 每个节点的命中与跨节点访问统计; 单节点机器上所有访问都是本地的
+void testNumaSharding(int) {
+    std::cout << "\n=== 测试场景16：NUMA 感知分片 ===" << std::endl;
+
+    const int CAPACITY = 400;
+    const int THREADS = 4;
+    const int OPERATIONS = 50000;
+    const int KEYS = 2000;
+
+    // 每个线程只访问自己的一段键空间(线程绑定的键空间)
+    std::vector<std::vector<std::pair<bool, int>>> perThread(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        WorkloadRng rng(kSeed + t);
+        for (int op = 0; op < OPERATIONS; ++op) {
+            perThread[t].push_back({rng.uniform() < 0.3, t * KEYS + static_cast<int>(rng.below(KEYS / 4))});
+        }
+    }
+
+    auto report = [](const std::string& name, auto& cache) {
+        for (int node = 0; node < cache.nodeCount(); ++node) {
+            auto stats = cache.nodeStats(node);
+            std::cout << std::left << std::setw(22) << name << std::right << " 节点 " << node
+                      << " - 命中: " << stats.hits << " 未命中: " << stats.misses
+                      << " 本地访问: " << stats.localAccesses << " 跨节点访问: " << stats.remoteAccesses << std::endl;
+        }
+    };
+
+    HashLruCache<int, std::string> hashLru(CAPACITY, THREADS);
+    NumaHashLruCache<int, std::string> numaHash(CAPACITY, THREADS, NumaRouting::Hash);
+    NumaHashLruCache<int, std::string> numaLocal(CAPACITY, THREADS, NumaRouting::Local);
+    NumaHashLfuCache<int, std::string> numaLfu(CAPACITY, THREADS, NumaRouting::Hash, 30);
+
+    std::cout << "NUMA 节点数: " << NumaTopology::instance().nodeCount() << " 线程数: " << THREADS << std::endl;
+    runThreadedCase("HashLruCache", hashLru, perThread);
+    runThreadedCase("NumaHashLru(Hash)", numaHash, perThread);
+    runThreadedCase("NumaHashLru(Local)", numaLocal, perThread);
+    runThreadedCase("NumaHashLfu(Hash)", numaLfu, perThread);
+    report("NumaHashLru(Hash)", numaHash);
+    report("NumaHashLru(Local)", numaLocal);
+}
+
+// 键在分片之间分布倾斜时, 静态容量切分与全局容量的对比
+void testGlobalSharding(int) {
+    std::cout << "\n=== 测试场景17：全局容量分片 LRU ===" << std::endl;
+
+    const int CAPACITY = 400;
+    const int SHARDS = 4;
+    const int THREADS = 4;
+    const int OPERATIONS = 100000;
+
+    // 70% 的访问落在 Zipf 热键上, 热键都是 SHARDS 的倍数(整数键的哈希为恒等映射, 全部落入同一分片),
+    // 其余访问均匀分布在整个键空间
+    std::vector<std::vector<std::pair<bool, int>>> perThread(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        WorkloadRng rng(kSeed + t);
+        ZipfGenerator zipf(2000, 0.9);
+        for (int op = 0; op < OPERATIONS; ++op) {
+            int key = rng.uniform() < 0.7 ? static_cast<int>(zipf(rng, op)) * SHARDS
+                                          : static_cast<int>(rng.below(20000));
+            perThread[t].push_back({rng.uniform() < 0.3, key});
         }
+    }
+
+    {
+        LruCache<int, std::string> lru(CAPACITY);
+        HashLruCache<int, std::string> hashLru(CAPACITY, SHARDS);
+        GlobalHashLruCache<int, std::string> globalLru(CAPACITY, SHARDS);
+        std::cout << "单线程, 容量 " << CAPACITY << " 分片数 " << SHARDS << std::endl;
+        runPolicyCase<caChepolicy<int, std::string>>("LruCache", lru, perThread[0]);
+        runPolicyCase<caChepolicy<int, std::string>>("HashLruCache(static split)", hashLru, perThread[0]);
+        runPolicyCase<caChepolicy<int, std::string>>("GlobalHashLruCache", globalLru, perThread[0]);
+        std::cout << "GlobalHashLruCache 各分片条目数:";
+        for (size_t n : globalLru.shardSizes()) std::cout << " " << n;
+        std::cout << " (总数 " << globalLru.size() << ")" << std::endl;
+    }
+
+    HashLruCache<int, std::string> hashLru(CAPACITY, SHARDS);
+    GlobalHashLruCache<int, std::string> globalLru(CAPACITY, SHARDS);
+    std::cout << THREADS << " 线程" << std::endl;
+    runThreadedCase("HashLruCache(static split)", hashLru, perThread);
+    runThreadedCase("GlobalHashLruCache", globalLru, perThread);
+}
+
+// 扁平表 + 采样淘汰的近似 LRU / LFU: 相对精确策略的命中率损失, 以及元数据开销
+void testSampledEviction(int) {
+    std::cout << "\n=== 测试场景18：采样近似 LRU / LFU ===" << std::endl;
 
-        // 重放操作序列
+    const int CAPACITY = 1000;
+    const int KEYS = 100000;
+    const size_t OPERATIONS = 500000;
+
+    auto hitRate = [](caChepolicy<int, std::string>& cache, const std::vector<std::pair<bool, int>>& operations) {
+        int hits = 0, gets = 0;
+        std::string result;
+        const std::string value = "value";
         for (const auto& op : operations) {
-            if (op.isPut) {
-                std::string value = "value" + std::to_string(op.key) + "_p" + std::to_string(op.phase);
-                caches[i]->put(op.key, value);
+            if (op.first) cache.put(op.second, value);
+            else if (++gets, cache.get(op.second, result)) ++hits;
+        }
+        return 100.0 * hits / gets;
+    };
+
+    auto run = [&](const std::string& name, const auto& generator) {
+        auto operations = generateOps(generator, OPERATIONS, 0.2, kSeed);
+        LruCache<int, std::string> lru(CAPACITY);
+        SampledCache<int, std::string> sampledLru5(CAPACITY, SampledPolicy::Lru, 5);
+        SampledCache<int, std::string> sampledLru10(CAPACITY, SampledPolicy::Lru, 10);
+        LfuCache<int, std::string> lfu(CAPACITY, 1000000);
+        SampledCache<int, std::string> sampledLfu5(CAPACITY, SampledPolicy::Lfu, 5);
+        SampledCache<int, std::string> sampledLfu10(CAPACITY, SampledPolicy::Lfu, 10);
+        double exactLru = hitRate(lru, operations);
+        double exactLfu = hitRate(lfu, operations);
+        std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+                  << " - LRU " << exactLru << "%  K=5 " << hitRate(sampledLru5, operations) - exactLru
+                  << "  K=10 " << hitRate(sampledLru10, operations) - exactLru
+                  << " | LFU " << exactLfu << "%  K=5 " << hitRate(sampledLfu5, operations) - exactLfu
+                  << "  K=10 " << hitRate(sampledLfu10, operations) - exactLfu << std::endl;
+    };
+
+    std::cout << "缓存大小: " << CAPACITY << " 键空间: " << KEYS << " 操作次数: " << OPERATIONS
+              << " (采样版本列出相对精确策略的命中率差, 单位为百分点)" << std::endl;
+    run("Zipf(0.99)", ZipfGenerator(KEYS, 0.99));
+    run("ScrambledZipf", ScrambledZipfGenerator(KEYS, 0.99));
+    run("Hotspot(1%/90%)", HotspotGenerator(KEYS, 0.01, 0.9));
+    run("Latest", LatestGenerator(KEYS, 0.99, 10));
+    run("LoopMix", LoopMixGenerator({{CAPACITY / 2, 0.5}, {CAPACITY * 4, 0.5}}));
+
+    // 100 万个 int 条目的内存与耗时
+    using Alloc = CountingAllocator<char>;
+    const int ENTRIES = 1000000;
+    auto footprint = [&](const std::string& name, AllocationStats& stats, caChepolicy<int, int>& cache) {
+        Timer timer;
+        int value;
+        for (int key = 0; key < ENTRIES * 2; ++key) cache.put(key, key);
+        for (int key = 0; key < ENTRIES * 2; ++key) cache.get(key, value);
+        std::cout << std::left << std::setw(16) << name << std::right << " - 字节/条目: " << std::fixed
+                  << std::setprecision(1) << static_cast<double>(stats.liveBytes.load()) / ENTRIES
+                  << "  耗时: " << timer.elapsed() << "ms" << std::endl;
+    };
+    {
+        AllocationStats stats;
+        LruCache<int, int, std::mutex, Alloc> cache(ENTRIES, Alloc(&stats));
+        footprint("LRU", stats, cache);
+    }
+    {
+        AllocationStats stats;
+        SampledCache<int, int, std::mutex, Alloc> cache(ENTRIES, SampledPolicy::Lru, 5, Alloc(&stats));
+        footprint("SampledLRU", stats, cache);
+    }
+    {
+        AllocationStats stats;
+        LfuCache<int, int, std::mutex, Alloc> cache(ENTRIES, 1000000, Alloc(&stats));
+        footprint("LFU", stats, cache);
+    }
+    {
+        AllocationStats stats;
+        SampledCache<int, int, std::mutex, Alloc> cache(ENTRIES, SampledPolicy::Lfu, 5, Alloc(&stats));
+        footprint("SampledLFU", stats, cache);
+    }
+}
+
+// 大容量 LFU 的老化: 平均频次超限后老化分摊到后续操作中, 观察尾延迟是否出现停顿
+// 500 万条目设置环境变量 CACHE_BENCH_LARGE 后才运行
+void testLfuAging(int) {
+    std::cout << "\n=== 测试场景19：LFU 分摊老化 ===" << std::endl;
+
+    const int CAPACITY = std::getenv("CACHE_BENCH_LARGE") ? 5000000 : 1000000;
+    const size_t OPERATIONS = 4000000;
+
+    // 循环访问全部键, 各键频次同步上升, 平均频次会反复越过上限
+    auto operations = generateOps(ScanGenerator(CAPACITY), OPERATIONS, 0.2, kSeed);
+    std::cout << "缓存大小: " << CAPACITY << " 操作次数: " << OPERATIONS << std::endl;
+
+    // 预先写满全部键, 之后每次访问都命中; 最大平均频次取 2
+    LfuCache<int, std::string> lfu(CAPACITY, 2);
+    for (int key = 0; key < CAPACITY; ++key) lfu.put(key, "value");
+    printLatency("LfuCache(amortized aging)", measureLatency(lfu, operations));
+}
+
+// 过滤一次性访问的几种策略: LRU-K(两个缓存) 与 共用节点存储的 SLRU / 2Q
+void testScanResistance(int) {
+    std::cout << "\n=== 测试场景20：SLRU 与 2Q ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int KEYS = 100000;
+    const size_t OPERATIONS = 1000000;
+
+    PhaseSchedule zipfWithScans;
+    zipfWithScans.add(ZipfGenerator(KEYS, 0.99), OPERATIONS / 4)
+                 .add(ScanGenerator(CAPACITY * 5, KEYS), OPERATIONS / 8)
+                 .add(ZipfGenerator(KEYS, 0.99), OPERATIONS / 4)
+                 .add(ScanGenerator(CAPACITY * 5, KEYS * 2), OPERATIONS / 8)
+                 .add(ZipfGenerator(KEYS, 0.99), OPERATIONS / 4);
+
+    auto run = [&](const std::string& name, const auto& generator) {
+        auto operations = generateOps(generator, OPERATIONS, 0.2, kSeed);
+        LruCache<int, std::string> lru(CAPACITY);
+        LruKCache<int, std::string> lruK(CAPACITY, CAPACITY * 2, 2);
+        SlruCache<int, std::string> slru(CAPACITY);
+        TwoQueueCache<int, std::string> twoQueue(CAPACITY);
+        std::array<caChepolicy<int, std::string>*, 4> caches = {&lru, &lruK, &slru, &twoQueue};
+        std::cout << std::left << std::setw(16) << name << std::right << " - 命中率:";
+        const std::string value = "value";
+        for (auto* cache : caches) {
+            int hits = 0, gets = 0;
+            std::string result;
+            Timer timer;
+            for (const auto& op : operations) {
+                if (op.first) cache->put(op.second, value);
+                else if (++gets, cache->get(op.second, result)) ++hits;
+            }
+            std::cout << " " << std::fixed << std::setprecision(2) << 100.0 * hits / gets << "%("
+                      << std::setprecision(0) << timer.elapsed() << "ms)";
+        }
+        std::cout << std::endl;
+    };
+
+    std::cout << "缓存大小: " << CAPACITY << " 键空间: " << KEYS << " 操作次数: " << OPERATIONS
+              << " (依次为 LRU / LRU-K / SLRU / 2Q)" << std::endl;
+    run("Zipf(0.99)", ZipfGenerator(KEYS, 0.99));
+    run("Zipf+Scan", zipfWithScans);
+    run("Hotspot(1%/90%)", HotspotGenerator(KEYS, 0.01, 0.9));
+    run("LoopMix", LoopMixGenerator({{CAPACITY / 2, 0.5}, {CAPACITY * 4, 0.5}}));
+
+    // 每条目内存: 写入容量两倍的键, 每个键写两次
+    using Alloc = CountingAllocator<char>;
+    const int ENTRIES = 100000;
+    auto footprint = [&](const std::string& name, AllocationStats& stats, caChepolicy<int, int>& cache) {
+        for (int key = 0; key < ENTRIES * 2; ++key) {
+            cache.put(key, key);
+            cache.put(key, key);
+        }
+        std::cout << std::left << std::setw(16) << name << std::right << " - 字节/条目: " << std::fixed
+                  << std::setprecision(1) << static_cast<double>(stats.liveBytes.load()) / ENTRIES << std::endl;
+    };
+    {
+        AllocationStats stats;
+        LruKCache<int, int, Alloc> cache(ENTRIES, ENTRIES, 2, Alloc(&stats));
+        footprint("LRU-K", stats, cache);
+    }
+    {
+        AllocationStats stats;
+        SlruCache<int, int, std::mutex, Alloc> cache(ENTRIES, 0.8, Alloc(&stats));
+        footprint("SLRU", stats, cache);
+    }
+    {
+        AllocationStats stats;
+        TwoQueueCache<int, int, std::mutex, Alloc> cache(ENTRIES, 0.25, 0.5, Alloc(&stats));
+        footprint("2Q", stats, cache);
+    }
+}
+
+// 不存在键的负缓存: 一半查询的键在后端不存在, 比较后端访问次数
+void testNegativeCache(int) {
+    std::cout << "\n=== 测试场景21：不存在键的负缓存(计数布隆过滤器) ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int KEYS = 100000; // 偶数键存在于后端, 奇数键不存在
+    const size_t OPERATIONS = 1000000;
+
+    auto operations = generateOps(ScrambledZipfGenerator(KEYS, 0.9), OPERATIONS, 0.0, kSeed);
+    // 后端每次访问模拟 1us 的开销
+    size_t backendCalls = 0;
+    auto loader = [&](int key, std::string& value) {
+        ++backendCalls;
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+        while (std::chrono::steady_clock::now() < until) {}
+        if (key % 2 != 0) return false;
+        value = "value" + std::to_string(key);
+        return true;
+    };
+
+    auto run = [&](const std::string& name, auto&& lookup) {
+        backendCalls = 0;
+        size_t found = 0;
+        std::string value;
+        Timer timer;
+        for (const auto& op : operations) {
+            if (lookup(op.second, value)) ++found;
+        }
+        std::cout << std::left << std::setw(24) << name << std::right << " - 找到: " << found
+                  << " 后端访问: " << backendCalls << "  耗时: " << timer.elapsed() << "ms" << std::endl;
+    };
+
+    {
+        HashLruCache<int, std::string> cache(CAPACITY, 4);
+        run("HashLruCache", [&](int key, std::string& value) {
+            if (cache.get(key, value)) return true;
+            if (!loader(key, value)) return false;
+            cache.put(key, value);
+            return true;
+        });
+    }
+    HashLruCache<int, std::string> cache(CAPACITY, 4);
+    NegativeCache<int, std::string> negative(cache, KEYS / 2, std::chrono::milliseconds(60000));
+    run("HashLruCache+Negative", [&](int key, std::string& value) {
+        return negative.getOrLoad(key, value, loader);
+    });
+
+    // 存在的键从未记为不存在, 被判为不存在的比例即假阳性率
+    size_t falsePositives = 0;
+    Timer timer;
+    for (int key = 0; key < KEYS; key += 2) falsePositives += negative.knownAbsent(key);
+    double ns = timer.elapsed() * 1e6 / (KEYS / 2);
+    std::cout << "过滤器: " << negative.filter().bytes() / 1024 << "KB, " << negative.filter().hashes()
+              << " 个哈希  假阳性: " << falsePositives << "/" << KEYS / 2
+              << "  每次查询: " << std::fixed << std::setprecision(1) << ns << "ns" << std::endl;
+
+    // 过期: 条目在 ttl 到 1.5 倍 ttl 之间失效; put 会立即删除记录
+    NegativeCache<int, std::string> shortLived(cache, 100, std::chrono::milliseconds(100));
+    shortLived.markAbsent(-1);
+    shortLived.markAbsent(-2);
+    shortLived.put(-2, "now present");
+    bool before = shortLived.knownAbsent(-1);
+    bool afterPut = shortLived.knownAbsent(-2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::cout << "ttl=100ms: 写入后 " << (before ? "不存在" : "未知") << ", put 之后 " << (afterPut ? "不存在" : "未知")
+              << ", 200ms 后 " << (shortLived.knownAbsent(-1) ? "不存在" : "未知") << std::endl;
+
+    // 同一个键被记为不存在两次(两个线程同时未命中), 之后的 put 仍须让它可以读到
+    NegativeCache<int, std::string> twice(cache, 100, std::chrono::milliseconds(60000));
+    twice.markAbsent(7);
+    twice.markAbsent(7);
+    twice.put(7, "value7");
+    std::string loaded;
+    bool found = twice.getOrLoad(7, loaded, [](int, std::string&) {return false;});
+    std::cout << "重复 markAbsent 后 put: knownAbsent = " << twice.knownAbsent(7) << ", getOrLoad "
+              << (found && loaded == "value7" ? "读到写入的值" : "未找到(错误)") << std::endl;
+}
+
+// 大值压缩存储: 1-100KB 的 JSON 类文本, 容量按编码后的字节数计算
+void testCompressedValues(int) {
+    std::cout << "\n=== 测试场景22：值压缩(LZ4 块格式) ===" << std::endl;
+
+    const int KEYS = 1000;
+    const size_t BYTES = 8 << 20;
+    const size_t OPERATIONS = 50000;
+
+    // 值大小在 1KB 到 100KB 之间按对数均匀分布
+    WorkloadRng rng(kSeed);
+    auto sizeOf = [&]() {return static_cast<size_t>(1024 * std::pow(100.0, rng.uniform()));};
+    std::vector<std::string> json(KEYS), random(KEYS);
+    for (int key = 0; key < KEYS; ++key) {
+        size_t size = sizeOf();
+        std::string& text = json[key];
+        for (int id = 0; text.size() < size; ++id) {
+            text += "{\"id\":" + std::to_string(key * 1000 + id) + ",\"name\":\"user" + std::to_string(rng.below(100000))
+                  + "\",\"active\":" + (rng.uniform() < 0.5 ? "true" : "false") + ",\"score\":"
+                  + std::to_string(rng.below(1000000) / 1000.0) + ",\"tags\":[\"cache\",\"lru\"]},";
+        }
+        text.resize(size);
+        random[key].resize(size);
+        for (char& c : random[key]) c = static_cast<char>(rng.next());
+    }
+    auto operations = generateOps(ScrambledZipfGenerator(KEYS, 0.9), OPERATIONS, 0.2, kSeed);
+
+    auto run = [&](const std::string& name, caChepolicy<int, std::string>& cache,
+                   const std::vector<std::string>& values, auto weight) {
+        int hits = 0, gets = 0, corrupt = 0;
+        size_t bytes = 0;
+        std::string result;
+        Timer timer;
+        for (const auto& op : operations) {
+            const std::string& value = values[op.second];
+            bytes += value.size();
+            if (op.first) {
+                cache.put(op.second, value);
+            } else if (++gets, cache.get(op.second, result)) {
+                ++hits;
+                if (result != value) ++corrupt;
+            }
+        }
+        double ms = timer.elapsed();
+        std::cout << std::left << std::setw(24) << name << std::right << " - 命中率: " << std::fixed << std::setprecision(2)
+                  << 100.0 * hits / gets << "%  已用: " << weight() / 1024 << "KB  吞吐: " << std::setprecision(0)
+                  << bytes / 1048576.0 / ms * 1000 << "MB/s  校验失败: " << corrupt << std::endl;
+    };
+    auto ratio = [](const auto& stats) {
+        std::cout << "    压缩: " << stats.compressed.load() << " 原样: " << stats.stored.load()
+                  << " (放弃压缩 " << stats.skipped.load() << ")  压缩比: " << std::fixed << std::setprecision(2)
+                  << static_cast<double>(stats.rawBytes.load()) / stats.encodedBytes.load() << std::endl;
+    };
+
+    std::cout << "键: " << KEYS << " 字节容量: " << (BYTES >> 20) << "MB 操作次数: " << OPERATIONS << std::endl;
+    {
+        LruCache<int, std::string> lru(KEYS);
+        lru.setWeigher(BYTES, [](const int&, const std::string& value) {return value.size();});
+        run("LruCache(原样)", lru, json, [&] {return lru.weight();});
+    }
+    {
+        LruCache<int, std::string> lru(KEYS);
+        CompressedCache<int, LruCache<int, std::string>> compressed(lru, BYTES);
+        run("LruCache(压缩)", compressed, json, [&] {return lru.weight();});
+        ratio(compressed.stats());
+    }
+    {
+        HashLruCache<int, std::string> hashLru(KEYS, 4);
+        CompressedCache<int, HashLruCache<int, std::string>> compressed(hashLru, BYTES);
+        run("HashLruCache(压缩)", compressed, json, [&] {return hashLru.weight();});
+    }
+
+    // 不可压缩的数据: 试探开头 4KB 后跳过 vs 每次完整压缩
+    std::cout << "随机字节(不可压缩):" << std::endl;
+    {
+        LruCache<int, std::string> lru(KEYS);
+        lru.setWeigher(BYTES, [](const int&, const std::string& value) {return value.size();});
+        run("LruCache(原样)", lru, random, [&] {return lru.weight();});
+    }
+    {
+        LruCache<int, std::string> lru(KEYS);
+        CompressedCache<int, LruCache<int, std::string>> compressed(lru, BYTES);
+        run("LruCache(压缩, 试探)", compressed, random, [&] {return lru.weight();});
+        ratio(compressed.stats());
+    }
+    {
+        CompressionOptions options;
+        options.probeBytes = 0;
+        LruCache<int, std::string> lru(KEYS);
+        CompressedCache<int, LruCache<int, std::string>> compressed(lru, BYTES, options);
+        run("LruCache(压缩, 不试探)", compressed, random, [&] {return lru.weight();});
+        ratio(compressed.stats());
+    }
+}
+
+// 统计各分区收到的读取次数, 用于观察热键复制的负载分布
+class CountingPartition : public CachePartition<int, std::string>{
+public:
+    explicit CountingPartition(HashLruCache<int, std::string>& cache) : _inner(cache) {}
+    void putBatch(const std::vector<std::pair<int, std::string>>& entries) override {_inner.putBatch(entries);}
+    void eraseBatch(const std::vector<int>& keys) override {_inner.eraseBatch(keys);}
+    void getBatch(const std::vector<int>& keys, std::vector<std::string>& values, std::vector<char>& found) override {
+        reads += keys.size();
+        _inner.getBatch(keys, values, found);
+    }
+    size_t reads = 0;
+private:
+    LocalPartition<int, std::string> _inner;
+};
+
+// 多个进程各自缓存 vs 一致性哈希分区共享缓存; Unix 域套接字上的批量读取; 热键复制
+void testPartitionedCache(int) {
+    std::cout << "\n=== 测试场景23：一致性哈希分区缓存 ===" << std::endl;
+
+    const int PARTITIONS = 4;
+    const int CAPACITY = 500; // 每个进程 / 每个分区的容量
+    const int KEYS = 20000;
+    const size_t OPERATIONS = 200000;
+
+    // 4 个"进程"访问同一个键空间, 操作轮流交给各进程
+    auto operations = generateOps(ScrambledZipfGenerator(KEYS, 0.9), OPERATIONS, 0.2, kSeed);
+    auto runProcesses = [&](const std::string& name, auto&& cacheOf) {
+        int hits = 0, gets = 0;
+        std::string result;
+        for (size_t i = 0; i < operations.size(); ++i) {
+            caChepolicy<int, std::string>& cache = cacheOf(static_cast<int>(i % PARTITIONS));
+            const auto& op = operations[i];
+            if (op.first) {
+                cache.put(op.second, "value" + std::to_string(op.second));
             } else {
-                std::string result;
-                get_operations[i]++;
-                if (caches[i]->get(op.key, result)) {
-                    hits[i]++;
+                ++gets;
+                if (cache.get(op.second, result)) ++hits;
+            }
+        }
+        std::cout << std::left << std::setw(28) << name << std::right << " - 命中率: " << std::fixed
+                  << std::setprecision(2) << 100.0 * hits / gets << "%" << std::endl;
+    };
+
+    std::cout << PARTITIONS << " 个进程, 总容量 " << PARTITIONS * CAPACITY << std::endl;
+    {
+        std::vector<std::unique_ptr<HashLruCache<int, std::string>>> local;
+        for (int p = 0; p < PARTITIONS; ++p) local.emplace_back(new HashLruCache<int, std::string>(CAPACITY, 1));
+        runProcesses("Independent HashLruCache", [&](int p) -> caChepolicy<int, std::string>& {return *local[p];});
+        // 各进程缓存的键的并集即实际能容纳的不同键数
+        std::unordered_set<int> distinct;
+        size_t entries = 0;
+        std::string value;
+        for (int key = 0; key < KEYS; ++key) {
+            for (auto& cache : local) {
+                if (cache->get(key, value)) {
+                    ++entries;
+                    distinct.insert(key);
                 }
             }
         }
+        std::cout << "    条目: " << entries << " 不同键: " << distinct.size() << std::endl;
+    }
+    {
+        std::vector<std::unique_ptr<HashLruCache<int, std::string>>> backing;
+        std::vector<std::unique_ptr<CachePartition<int, std::string>>> partitions;
+        for (int p = 0; p < PARTITIONS; ++p) {
+            backing.emplace_back(new HashLruCache<int, std::string>(CAPACITY, 1));
+            partitions.emplace_back(new LocalPartition<int, std::string>(*backing.back()));
+        }
+        PartitionedCache<int, std::string> shared(std::move(partitions));
+        runProcesses("PartitionedCache", [&](int) -> caChepolicy<int, std::string>& {return shared;});
+    }
+
+    // 每个分区在各自的服务线程中, 客户端通过 Unix 域套接字访问: 逐个读取 vs 每批 64 个
+    {
+        const int BATCH = 64;
+        const int READS = 100000;
+        std::vector<std::unique_ptr<HashLruCache<int, std::string>>> backing;
+        std::vector<std::unique_ptr<PartitionServer<int, std::string>>> servers;
+        std::vector<std::unique_ptr<CachePartition<int, std::string>>> partitions;
+        std::vector<UnixSocketPartition<int, std::string>*> clients;
+        std::string prefix = "ccCacheTest-" + std::to_string(::getpid()) + "-";
+        for (int p = 0; p < PARTITIONS; ++p) {
+            backing.emplace_back(new HashLruCache<int, std::string>(KEYS, 1));
+            servers.emplace_back(new PartitionServer<int, std::string>(*backing.back(), prefix + std::to_string(p)));
+            clients.push_back(new UnixSocketPartition<int, std::string>(prefix + std::to_string(p)));
+            partitions.emplace_back(clients.back());
+        }
+        PartitionedCache<int, std::string> remote(std::move(partitions));
+        std::vector<std::pair<int, std::string>> entries;
+        for (int key = 0; key < KEYS; ++key) entries.push_back({key, "value" + std::to_string(key)});
+        remote.putMany(entries);
+
+        WorkloadRng rng(kSeed);
+        std::vector<int> keys(READS);
+        for (int& key : keys) key = static_cast<int>(rng.below(KEYS));
+        size_t found = 0;
+        std::string value;
+        Timer single;
+        for (int key : keys) found += remote.get(key, value);
+        double singleMs = single.elapsed();
+        std::cout << std::left << std::setw(28) << "UnixSocket get" << std::right << " - 找到: " << found << "/" << READS << "  吞吐: " << std::setprecision(0)
+                  << READS / std::max(singleMs, 1.0) * 1000 << " ops/s" << std::endl;
+
+        found = 0;
+        std::vector<int> batch;
+        std::vector<std::string> values;
+        std::vector<char> hit;
+        Timer batched;
+        for (int i = 0; i < READS; i += BATCH) {
+            batch.assign(keys.begin() + i, keys.begin() + std::min(i + BATCH, READS));
+            remote.getMany(batch, values, hit);
+            for (char h : hit) found += h;
+        }
+        double batchMs = batched.elapsed();
+        std::cout << std::left << std::setw(28) << "UnixSocket getMany(" + std::to_string(BATCH) + ")" << std::right << " - 找到: " << found << "/" << READS << "  吞吐: "
+                  << READS / std::max(batchMs, 1.0) * 1000 << " ops/s" << std::endl;
+
+        // 不合法的帧(长度超过上限 / 个数超过负载长度)只断开该连接, 服务端继续工作, 连接随即关闭回收
+        auto sendRaw = [&](const std::string& frame) {
+            socklen_t length;
+            sockaddr_un addr = wire::abstractAddress(prefix + "0", length);
+            int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), length) == 0) {
+                wire::sendAll(fd, frame.data(), frame.size());
+                char byte;
+                ::recv(fd, &byte, 1, 0); // 等服务端断开
+            }
+            ::close(fd);
+        };
+        std::string huge;
+        WireCodec<uint32_t>::encode(0xFFFFFFFFu, huge);
+        std::string badCount;
+        WireCodec<uint32_t>::encode(5, badCount);
+        badCount.push_back('G');
+        WireCodec<uint32_t>::encode(0xFFFFFFFFu, badCount);
+        sendRaw(huge);
+        sendRaw(badCount);
+        for (int i = 0; i < 100 && servers[0]->connections() > 1; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        int probe = 0;
+        while (remote.partitionOf(probe) != 0) ++probe;
+        bool alive = remote.get(probe, value);
+        std::cout << "不合法的帧之后: 服务端仍可读取 " << (alive ? "是" : "否") << "  分区 0 打开的连接: "
+                  << servers[0]->connections() << std::endl;
+
+        // 同一分区上超过帧上限(64MB)的批量写入与读取: 拆成多帧, 连接保持可用
+        {
+            const int LARGE = 700;
+            std::vector<std::pair<int, std::string>> large;
+            for (int key = KEYS; static_cast<int>(large.size()) < LARGE; ++key) {
+                if (remote.partitionOf(key) == 0) large.push_back({key, std::string(100 * 1024, 'x')});
+            }
+            remote.putMany(large);
+            std::vector<int> largeKeys;
+            for (const auto& entry : large) largeKeys.push_back(entry.first);
+            std::vector<std::string> largeValues;
+            std::vector<char> largeFound;
+            remote.getMany(largeKeys, largeValues, largeFound);
+            size_t intact = 0;
+            for (size_t i = 0; i < large.size(); ++i) intact += largeFound[i] && largeValues[i].size() == large[i].second.size();
+            std::cout << "分区 0 上 " << LARGE << " 个 100KB 的值(约 70MB)一批写入再读取: 完整 " << intact << "/" << LARGE
+                      << "  连接出错: " << clients[0]->errors() << std::endl;
+        }
+
+        // 服务端重启: 旧连接出错断开, 下一次调用重新连接
+        servers[0].reset();
+        servers[0].reset(new PartitionServer<int, std::string>(*backing[0], prefix + "0"));
+        bool first = remote.get(probe, value);
+        bool second = remote.get(probe, value);
+        std::cout << "分区 0 服务端重启后: 第一次读取 " << (first ? "命中" : "未命中") << "  第二次读取 "
+                  << (second ? "命中" : "未命中") << "  连接出错: " << clients[0]->errors() << std::endl;
+
+        // 删除帧: 写入后再删除, 之后的读取不命中
+        remote.put(probe, "value");
+        clients[remote.partitionOf(probe)]->eraseBatch({probe});
+        std::cout << "删除后读取: " << (remote.get(probe, value) ? "命中" : "未命中") << std::endl;
+    }
+
+    // 分区数从 4 增加到 5 时换分区的键的比例(理想值 1/5)
+    {
+        HashLruCache<int, std::string> dummy(1, 1);
+        auto make = [&](int n) {
+            std::vector<std::unique_ptr<CachePartition<int, std::string>>> partitions;
+            for (int p = 0; p < n; ++p) partitions.emplace_back(new LocalPartition<int, std::string>(dummy));
+            return PartitionedCache<int, std::string>(std::move(partitions));
+        };
+        PartitionedCache<int, std::string> four = make(PARTITIONS);
+        PartitionedCache<int, std::string> five = make(PARTITIONS + 1);
+        int moved = 0;
+        for (int key = 0; key < KEYS; ++key) moved += four.partitionOf(key) != five.partitionOf(key);
+        std::cout << "分区数 " << PARTITIONS << " -> " << PARTITIONS + 1 << ": 换分区的键 " << std::setprecision(2)
+                  << 100.0 * moved / KEYS << "%" << std::endl;
     }
 
-    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits);
+    // 倾斜很大的访问下, 热键复制到 2 个分区前后各分区的读取次数
+    auto skewed = generateOps(ZipfGenerator(KEYS, 1.2), OPERATIONS, 0.05, kSeed);
+    auto spread = [&](const std::string& name, int replicas) {
+        std::vector<std::unique_ptr<HashLruCache<int, std::string>>> backing;
+        std::vector<CountingPartition*> counters;
+        std::vector<std::unique_ptr<CachePartition<int, std::string>>> partitions;
+        for (int p = 0; p < PARTITIONS; ++p) {
+            backing.emplace_back(new HashLruCache<int, std::string>(CAPACITY, 1));
+            counters.push_back(new CountingPartition(*backing.back()));
+            partitions.emplace_back(counters.back());
+        }
+        PartitionedCache<int, std::string> cache(std::move(partitions));
+        if (replicas > 1) cache.enableHotReplication(replicas, 8, KEYS);
+        int hits = 0, gets = 0;
+        std::string result;
+        for (const auto& op : skewed) {
+            if (op.first) {
+                cache.put(op.second, "value" + std::to_string(op.second));
+            } else {
+                ++gets;
+                if (cache.get(op.second, result)) ++hits;
+            }
+        }
+        size_t most = 0, least = SIZE_MAX;
+        std::cout << std::left << std::setw(28) << name << std::right << " - 命中率: " << std::setprecision(2)
+                  << 100.0 * hits / gets << "%  各分区读取:";
+        for (CountingPartition* counter : counters) {
+            std::cout << " " << counter->reads;
+            most = std::max(most, counter->reads);
+            least = std::min(least, counter->reads);
+        }
+        std::cout << "  最多/最少: " << static_cast<double>(most) / std::max<size_t>(least, 1);
+        // 各分区保存的条目总数, 冷键只保存在主分区上
+        size_t entries = 0;
+        for (int key = 0; key < KEYS; ++key) {
+            for (auto& partition : backing) entries += partition->get(key, result);
+        }
+        std::cout << "  条目: " << entries << std::endl;
+    };
+    spread("Zipf(1.2) no replication", 1);
+    spread("Zipf(1.2) hot replicas x2", 2);
+
+    // 两个"进程"共用一组分区: 只有 A 把键 7 当作热键, B 的写入也要更新 A 会读取的副本
+    {
+        std::vector<std::unique_ptr<HashLruCache<int, std::string>>> backing;
+        auto partitionsOf = [&]() {
+            std::vector<std::unique_ptr<CachePartition<int, std::string>>> partitions;
+            for (auto& cache : backing) partitions.emplace_back(new LocalPartition<int, std::string>(*cache));
+            return partitions;
+        };
+        for (int p = 0; p < PARTITIONS; ++p) backing.emplace_back(new HashLruCache<int, std::string>(CAPACITY, 1));
+        PartitionedCache<int, std::string> a(partitionsOf());
+        PartitionedCache<int, std::string> b(partitionsOf());
+        a.enableHotReplication(2, 8, KEYS);
+        b.enableHotReplication(2, 8, KEYS);
+        std::string value;
+        a.put(7, "old");
+        for (int i = 0; i < 32; ++i) a.get(7, value);
+        a.put(7, "old");
+        b.put(7, "new");
+        int stale = 0;
+        for (int i = 0; i < 4; ++i) stale += a.get(7, value) && value != "new";
+        std::cout << "进程 B 写入热键后进程 A 的 4 次读取中过期的副本: " << stale << std::endl;
+    }
+}
+
+// 多个进程各自的 HashLruCache vs 共用一个共享内存缓存; 持锁进程被杀后的恢复
+void testSharedMemoryCache(int) {
+    std::cout << "\n=== 测试场景24：共享内存缓存(多进程) ===" << std::endl;
+
+    const int PROCESSES = 4;
+    const int CAPACITY = 2000; // 所有进程合计的条目数
+    const int KEYS = 20000;
+    const size_t OPERATIONS = 200000;
+    const std::string NAME = "/ccCacheTest-" + std::to_string(::getpid());
+
+    // 子进程的结果写在匿名共享映射中
+    struct Result{
+        std::atomic<long> hits;
+        std::atomic<long> gets;
+    };
+    auto* results = static_cast<Result*>(::mmap(nullptr, sizeof(Result) * PROCESSES, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    if (results == MAP_FAILED) return;
+
+    // 每个进程: 读取未命中时从"后端"加载并写入缓存
+    auto runProcesses = [&](const std::string& name, auto&& makeCache) {
+        for (int p = 0; p < PROCESSES; ++p) {
+            results[p].hits = 0;
+            results[p].gets = 0;
+        }
+        Timer timer;
+        for (int p = 0; p < PROCESSES; ++p) {
+            if (::fork() != 0) continue;
+            auto cache = makeCache(p);
+            auto operations = generateOps(ScrambledZipfGenerator(KEYS, 0.9), OPERATIONS, 0.0, kSeed + p);
+            std::string value;
+            long hits = 0;
+            for (const auto& op : operations) {
+                if (cache->get(op.second, value)) {
+                    ++hits;
+                } else {
+                    cache->put(op.second, "value" + std::to_string(op.second));
+                }
+            }
+            results[p].hits = hits;
+            results[p].gets = static_cast<long>(operations.size());
+            ::_exit(0);
+        }
+        while (::wait(nullptr) > 0) {}
+        double ms = timer.elapsed();
+        long hits = 0, gets = 0;
+        for (int p = 0; p < PROCESSES; ++p) {
+            hits += results[p].hits;
+            gets += results[p].gets;
+        }
+        std::cout << std::left << std::setw(28) << name << std::right << " - 命中率: " << std::fixed
+                  << std::setprecision(2) << 100.0 * hits / std::max(gets, 1L) << "%  耗时: " << ms << "ms" << std::endl;
+    };
+
+    std::cout << PROCESSES << " 个进程, 合计容量 " << CAPACITY << " 个条目" << std::endl;
+    runProcesses("HashLruCache per process", [&](int) {
+        return std::make_unique<HashLruCache<int, std::string>>(CAPACITY / PROCESSES, 4);
+    });
+    ShmCache<int, std::string>::unlink(NAME);
+    {
+        ShmCache<int, std::string> shared(NAME, CAPACITY, 4, 32);
+        if (!shared.attached()) {
+            std::cout << "无法创建共享内存段 " << NAME << std::endl;
+            ::munmap(results, sizeof(Result) * PROCESSES);
+            return;
+        }
+        runProcesses("ShmCache shared", [&](int) {
+            return std::make_unique<ShmCache<int, std::string>>(NAME, CAPACITY, 4, 32);
+        });
+        std::cout << "    共享段: " << shared.bytes() / 1024 << "KB, 条目: " << shared.size() << "/" << shared.capacity()
+                  << std::endl;
+    }
+    ShmCache<int, std::string>::unlink(NAME);
+
+    // 子进程不停写入, 随后被 SIGKILL; 若它当时持有分片锁, 下一个加锁的进程清空该分片后继续使用.
+    // 被杀时不一定持锁, 最多重复 20 次
+    {
+        ShmCache<int, std::string> shared(NAME, 64, 1, 32);
+        int kills = 0;
+        bool ok = true;
+        while (kills < 20 && shared.recoveries() == 0) {
+            pid_t child = ::fork();
+            if (child == 0) {
+                ShmCache<int, std::string> cache(NAME, 64, 1, 32);
+                for (int key = 0;; key = (key + 1) % 1000) cache.put(key, "value" + std::to_string(key));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            ::kill(child, SIGKILL);
+            ::waitpid(child, nullptr, 0);
+            ++kills;
+            shared.put(-1, "after crash");
+            std::string value;
+            ok = ok && shared.get(-1, value) && value == "after crash";
+        }
+        std::cout << "杀死写入进程 " << kills << " 次: 分片恢复次数 " << shared.recoveries() << ", 之后读写"
+                  << (ok ? "正常" : "异常") << std::endl;
+    }
+    ShmCache<int, std::string>::unlink(NAME);
+    ::munmap(results, sizeof(Result) * PROCESSES);
+}
+
+// 一个爆款键占一半读取时, 它所在分片的锁成为瓶颈; 热键前置缓存把它的读取留在各线程内
+void testHotKeyReplication(int) {
+    std::cout << "\n=== 测试场景25：热键检测与线程前置缓存 ===" << std::endl;
+
+    const int CAPACITY = 2000;
+    const int SHARDS = 8;
+    const int THREADS = 8;
+    const int OPERATIONS = 200000;
+    const int KEYS = 100000;
+    const int VIRAL = 42;
+
+    std::vector<std::vector<std::pair<bool, int>>> perThread(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        WorkloadRng rng(kSeed + t);
+        ScrambledZipfGenerator zipf(KEYS, 0.9);
+        for (int op = 0; op < OPERATIONS; ++op) {
+            int key = rng.uniform() < 0.5 ? VIRAL : static_cast<int>(zipf(rng, op));
+            perThread[t].push_back({rng.uniform() < 0.01, key});
+        }
+    }
+
+    {
+        HashLruCache<int, std::string> hashLru(CAPACITY, SHARDS);
+        runThreadedCase("HashLruCache", hashLru, perThread);
+    }
+    HashLruCache<int, std::string> hashLru(CAPACITY, SHARDS);
+    HotKeyCache<int, std::string> hot(hashLru);
+    runThreadedCase("HashLruCache+HotKey", hot, perThread);
+    size_t reads = 0;
+    for (const auto& ops : perThread) {
+        for (const auto& op : ops) reads += !op.first;
+    }
+    std::cout << "    热键数: " << hot.hotKeys() << "  前置缓存命中: " << hot.frontHits() << "/" << reads << " ("
+              << std::setprecision(2) << 100.0 * hot.frontHits() / reads << "%)" << std::endl;
 }
 
+// 每线程 L1 + 共享 L2 + 文件映射的 L3: 多数命中由 L1 提供; L3 的包含 / 独占两种模式
+void testTieredCache(int) {
+    std::cout << "\n=== 测试场景26：分层缓存(L1 / L2 / L3) ===" << std::endl;
+
+    const int CAPACITY = 2000;
+    const int THREADS = 4;
+    const int OPERATIONS = 200000;
+    const int KEYS = 20000;
 
+    std::vector<std::vector<std::pair<bool, int>>> perThread(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        perThread[t] = generateOps(ScrambledZipfGenerator(KEYS, 0.99), OPERATIONS, 0.05, kSeed + t);
+    }
+    auto report = [](const auto& stats) {
+        uint64_t reads = stats.l1Hits + stats.l2Hits + stats.l3Hits + stats.misses;
+        std::cout << "    L1: " << std::fixed << std::setprecision(2) << 100.0 * stats.l1Hits / reads << "%  L2: "
+                  << 100.0 * stats.l2Hits / reads << "%  L3: " << 100.0 * stats.l3Hits / reads << "%  未命中: "
+                  << 100.0 * stats.misses / reads << "%  提升: " << stats.promotions << " 降级: " << stats.demotions
+                  << " (放弃 " << stats.dropped << ")" << std::endl;
+    };
+
+    {
+        HashLruCache<int, std::string> hashLru(CAPACITY, THREADS);
+        runThreadedCase("HashLruCache", hashLru, perThread);
+    }
+    using TierEntryString = TierEntry<std::string>;
+    {
+        HashLruCache<int, TierEntryString> hashLru(CAPACITY, THREADS);
+        TieredCache<int, std::string, HashLruCache<int, TierEntryString>> tiered(hashLru);
+        runThreadedCase("L1 + HashLruCache", tiered, perThread);
+        report(tiered.stats());
+    }
+    {
+        ArcCahce<int, std::string> arc(CAPACITY, 2);
+        runThreadedCase("ArcCahce", arc, perThread);
+    }
+    {
+        ArcCahce<int, TierEntryString> arc(CAPACITY, 2);
+        TieredCache<int, std::string, ArcCahce<int, TierEntryString>> tiered(arc);
+        runThreadedCase("L1 + ArcCahce", tiered, perThread);
+        report(tiered.stats());
+    }
+
+    // L2 只有 500 个条目, L3 为 /tmp 下的内存映射文件, 可容纳全部键
+    const std::string PATH = "/tmp/ccCacheTest-spill-" + std::to_string(::getpid());
+    for (TierMode mode : {TierMode::Inclusive, TierMode::Exclusive}) {
+        ShmCache<int, std::string>::unlink(PATH, ShmBacking::File);
+        ShmCache<int, std::string> spill(PATH, KEYS, 4, 32, ShmBacking::File);
+        if (!spill.attached()) {
+            std::cout << "无法创建溢出文件 " << PATH << std::endl;
+            return;
+        }
+        HashLruCache<int, TierEntryString> hashLru(CAPACITY / 4, THREADS);
+        TierOptions options;
+        options.spillMode = mode;
+        options.versionStripes = 64 * CAPACITY / 4;
+        TieredCache<int, std::string, HashLruCache<int, TierEntryString>> tiered(hashLru, options, &spill);
+        runThreadedCase(mode == TierMode::Inclusive ? "L1 + L2 + L3(inclusive)" : "L1 + L2 + L3(exclusive)",
+                        tiered, perThread);
+        report(tiered.stats());
+        std::cout << "    L3 条目: " << spill.size() << "  文件: " << spill.bytes() / 1024 << "KB" << std::endl;
+    }
+
+    // 独占模式, L2 只有 1 个条目, 淘汰通知每 2 条投递一次: 1 的旧值 A 的降级通知在写入 B 之后才投递,
+    // 应被丢弃; B 被淘汰后在投递前读取为未命中, flush 之后从 L3 读到 B, 任何时候都不应读到 A
+    {
+        ShmCache<int, std::string>::unlink(PATH, ShmBacking::File);
+        ShmCache<int, std::string> spill(PATH, 16, 1, 32, ShmBacking::File);
+        LruCache<int, TierEntryString> lru(1);
+        TierOptions options;
+        options.spillMode = TierMode::Exclusive;
+        options.demoteBatch = 2;
+        TieredCache<int, std::string, LruCache<int, TierEntryString>> tiered(lru, options, &spill);
+        tiered.put(1, "A");
+        tiered.put(2, "X");
+        tiered.put(1, "B");
+        tiered.put(3, "Y");
+        std::string before, after;
+        if (!tiered.get(1, before)) before = "(未命中)";
+        tiered.flush();
+        tiered.put(4, "Z");
+        tiered.flush();
+        if (!tiered.get(1, after)) after = "(未命中)";
+        std::cout << "降级与写入交错: put(1,A) put(2,X) put(1,B) put(3,Y) 后 get(1) = " << before
+                  << ", flush 与更多写入之后 get(1) = " << after << "  放弃的降级: " << tiered.stats().dropped
+                  << std::endl;
+    }
+    ShmCache<int, std::string>::unlink(PATH, ShmBacking::File);
+}
 
 int main(){
     testHotDataAccess(1);
     testLoopPattern(1);
     testWorkloadShift(1);
+    testPolicyCache(1);
+    testPerCoreCache(1);
+    testConcurrentLfu(1);
+    testMaintenance(1);
+    testRemovalListener(1);
+    testNodeLayout(1);
+    testGhostProbe(1);
+    testGhostMemory(1);
+    testAdaptivePolicy(1);
+    testWorkloadLibrary(1);
+    testMemoryFootprint(1);
+    testPmrResources(1);
+    testNumaSharding(1);
+    testGlobalSharding(1);
+    testSampledEviction(1);
+    testLfuAging(1);
+    testScanResistance(1);
+    testNegativeCache(1);
+    testCompressedValues(1);
+    testPartitionedCache(1);
+    testSharedMemoryCache(1);
+    testHotKeyReplication(1);
+    testTieredCache(1);
     return 0;
 }
 